@@ -1,4 +1,11 @@
 #pragma once
+
+// IDs for paths cached by paths_register()
+enum path_ids {
+  PATH_EXAMPLE_OUT = 0,
+  PATH_EXAMPLE_BACK = 1
+};
+
 void default_constants();
 void drive_example();
 void turn_example();
@@ -13,7 +20,18 @@ void odom_pure_pursuit_example();
 void odom_pure_pursuit_wait_until_example();
 void odom_boomerang_example();
 void odom_boomerang_injected_pure_pursuit_example();
+void motion_queue_example();
+void profiled_motion_example();
+void odom_pp_buffer_example();
+void paths_register();
+void odom_pp_cached_example();
+void odom_pp_compiled_example();
+void trajectories_generate();
+void odom_spline_example();
+void odom_trajectory_file_example();
+void timeline_example();
 void measure_offsets();
+void characterize();
 
 //Match/Skills Autonomous Routes
 void MatchAutonAWP();
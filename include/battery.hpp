@@ -0,0 +1,78 @@
+#pragma once
+
+#include "api.h"
+
+/**
+ * Battery voltage compensation.
+ *
+ * Outputs out of 127 are a fraction of full voltage, so as the battery sags the
+ * same output pushes less.  With compensation on, outputs are scaled by
+ * nominal / measured voltage.  The battery is read by a low rate task and
+ * filtered, so compensating an output never waits on a read.
+ */
+namespace battery {
+/**
+ * Starts the task that reads the battery.  Run this in initialize().
+ *
+ * \param period
+ *        ms between reads
+ */
+void initialize(int period = 100);
+
+/**
+ * Sets the voltage outputs are scaled to match.  Defaults to 12.0V.
+ *
+ * \param volts
+ *        nominal voltage
+ */
+void nominal_set(double volts);
+
+/**
+ * Returns the voltage outputs are scaled to match.
+ */
+double nominal_get();
+
+/**
+ * Turns compensation on or off.  It's off by default.
+ *
+ * \param toggle
+ *        true to scale outputs with the battery voltage
+ */
+void compensation_toggle(bool toggle);
+
+/**
+ * Returns true if outputs are being compensated.
+ */
+bool compensation_enabled();
+
+/**
+ * Returns the filtered battery voltage in V.
+ */
+double voltage_get();
+
+/**
+ * Returns what outputs are multiplied by, 1 when compensation is off.
+ */
+double scale_get();
+
+/**
+ * Returns an output scaled for the battery and clamped to 127.
+ *
+ * \param output
+ *        output, -127 to 127
+ */
+double compensate(double output);
+
+/**
+ * A motor whose move() is battery compensated.  Everything else is pros::Motor.
+ *
+ * move() is virtual, so it's compensated through a pros::Motor& too.  Call
+ * pros::Motor::move() to send a raw output.
+ */
+class CompensatedMotor : public pros::Motor {
+ public:
+  using pros::Motor::Motor;
+
+  std::int32_t move(std::int32_t voltage) const override { return pros::Motor::move(compensate(voltage)); }
+};
+}  // namespace battery
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "api.h"
+
+/**
+ * Microbenchmarks for the control loop kernels.
+ *
+ * Each kernel is run in a tight loop and timed with BENCH_CLOCK(), which is
+ * pros::micros() on the brain.  tools/bench runs the same suite on the host,
+ * where it's the wall clock since pros::micros() is simulated time there.
+ *
+ * Heap allocations are only counted when the project is built with
+ * BENCH_ALLOCATIONS:=1 in the Makefile.  That replaces operator new for the
+ * whole program, so leave it off for competition builds.  Allocations made
+ * inside prebuilt libraries that are linked into the cold package are not
+ * seen.  Build with USE_PACKAGE:=0 to count those too.
+ */
+#ifndef BENCH_ALLOCATIONS
+#define BENCH_ALLOCATIONS 0
+#endif
+#ifndef BENCH_CLOCK
+#define BENCH_CLOCK pros::micros
+#endif
+
+namespace bench {
+/**
+ * Results from one benchmark.
+ */
+struct result {
+  const char* name;
+  int iterations;
+  double ns_per_op;
+  double allocs_per_op;
+};
+
+/**
+ * Returns how many times operator new has been called since the program started.
+ *
+ * This is always 0 unless the project is built with BENCH_ALLOCATIONS:=1.
+ */
+uint32_t allocations_get();
+
+/**
+ * Stores a value somewhere the compiler can't optimize away.
+ *
+ * \param value
+ *        result of the kernel
+ */
+void keep(double value);
+
+/**
+ * Prints a benchmark result to the terminal.
+ *
+ * \param r
+ *        result to print
+ */
+void result_print(result r);
+
+/**
+ * Times a kernel.
+ *
+ * The kernel is given the iteration number so inputs can change every call.
+ *
+ * \param name
+ *        name that prints with the result
+ * \param iterations
+ *        how many times to run the kernel
+ * \param kernel
+ *        function that takes an int and runs the code being measured
+ */
+template <typename F>
+result run(const char* name, int iterations, F&& kernel) {
+  // Run once first so lazy setup isn't counted
+  kernel(0);
+
+  uint32_t allocs = allocations_get();
+  uint64_t start = BENCH_CLOCK();
+  for (int i = 0; i < iterations; i++)
+    kernel(i);
+  uint64_t end = BENCH_CLOCK();
+  allocs = allocations_get() - allocs;
+
+  result r = {name, iterations, (end - start) * 1000.0 / iterations, (double)allocs / iterations};
+  result_print(r);
+  return r;
+}
+
+/**
+ * Runs every benchmark and prints the results to the terminal.
+ *
+ * This is meant to be run from the auton selector with the robot on a stand.
+ * The drive motors are disabled while paths are being set.
+ */
+void auton();
+}  // namespace bench
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <initializer_list>
+
+#include "EZ-Template/PID.hpp"
+
+/**
+ * PID constants that change with the motion.
+ *
+ * A schedule is a table of constants at points along a key, like how far the
+ * motion goes.  Constants between points are interpolated, and past either end
+ * they hold the closest point.
+ *
+ * Adding points resamples the table onto an even grid, so looking up constants
+ * is a couple of multiplies no matter how many points there are.
+ */
+class GainSchedule {
+ public:
+  /**
+   * What the schedule is looked up by.
+   */
+  enum e_key {
+    DISTANCE = 0,  // how far the motion goes, inches or degrees
+    ERROR = 1,     // how far the motion is from its target, looked up every loop
+    SPEED = 2      // max speed of the motion, 0 to 127
+  };
+
+  /**
+   * Constants at one point in the schedule.
+   */
+  struct point {
+    double at;
+    ez::PID::Constants constants;
+  };
+
+  /**
+   * Most points a schedule can have.
+   */
+  static const int MAX_POINTS = 8;
+
+  GainSchedule();
+
+  /**
+   * Creates a schedule.
+   *
+   * \param key
+   *        what the schedule is looked up by
+   * \param points
+   *        constants at each point, in any order
+   */
+  GainSchedule(e_key key, std::initializer_list<point> points);
+
+  /**
+   * Adds a point.  Returns false if the schedule is full.
+   *
+   * \param at
+   *        where on the key this point is
+   * \param constants
+   *        constants at this point
+   */
+  bool point_add(double at, ez::PID::Constants constants);
+
+  /**
+   * Removes every point.
+   */
+  void clear();
+
+  /**
+   * Returns true if the schedule has any points.
+   */
+  bool enabled() const;
+
+  /**
+   * Returns what the schedule is looked up by.
+   */
+  e_key key_get() const;
+
+  /**
+   * Returns the constants at a point on the key.
+   *
+   * \param at
+   *        where on the key to look, the sign is ignored
+   */
+  ez::PID::Constants get(double at) const;
+
+  /**
+   * Returns the constants a motion should start with.
+   *
+   * Error keyed schedules use the distance, that's the error the motion starts with.
+   *
+   * \param distance
+   *        how far the motion goes
+   * \param speed
+   *        max speed of the motion
+   */
+  ez::PID::Constants motion_get(double distance, double speed) const;
+
+ private:
+  static const int GRID_SIZE = 64;
+  e_key key = DISTANCE;
+  point points[MAX_POINTS];
+  int amount = 0;
+  ez::PID::Constants grid[GRID_SIZE + 1];
+  double grid_start = 0.0;
+  double grid_scale = 0.0;  // grid cells per unit of the key
+  ez::PID::Constants interpolate(double at) const;
+  void grid_build();
+};
@@ -0,0 +1,142 @@
+#pragma once
+
+#include "api.h"
+
+/**
+ * Measures how well a periodic loop keeps its rate.
+ *
+ * Call iteration_start() at the top of every loop iteration and iteration_end()
+ * right before the loop delays.  Periods and execution times are kept in
+ * histograms with 100us buckets, so summaries are accurate to 100us.
+ *
+ * Every LoopStats registers itself so all of them can be printed at once.
+ */
+class LoopStats {
+ public:
+  /**
+   * Summary of a histogram, all in microseconds.
+   */
+  struct summary {
+    uint32_t min;
+    uint32_t p50;
+    uint32_t p99;
+    uint32_t max;
+  };
+
+  /**
+   * Creates a new loop to measure.
+   *
+   * \param name
+   *        name that prints with the stats
+   * \param period
+   *        the period the loop is supposed to run at in ms
+   */
+  LoopStats(const char* name, int period);
+
+  /**
+   * Marks the start of an iteration and records the period since the last one.
+   */
+  void iteration_start();
+
+  /**
+   * Marks the end of an iteration and records how long it took.
+   */
+  void iteration_end();
+
+  /**
+   * Clears all measurements.
+   */
+  void reset();
+
+  /**
+   * Sets the period the loop is supposed to run at.
+   *
+   * \param period
+   *        period in ms
+   */
+  void period_nominal_set(int period);
+
+  /**
+   * Returns the period the loop is supposed to run at in ms.
+   */
+  int period_nominal_get();
+
+  /**
+   * Returns the measured period between iteration starts.
+   */
+  summary period_get();
+
+  /**
+   * Returns the measured time between iteration start and end.
+   */
+  summary execution_get();
+
+  /**
+   * Returns how many iterations started more than 1ms later than they should have.
+   */
+  uint32_t overruns_get();
+
+  /**
+   * Returns how many iterations have been measured.
+   */
+  uint32_t iterations_get();
+
+  /**
+   * Returns a one line summary of this loop.
+   */
+  std::string to_string();
+
+  /**
+   * Name that prints with the stats.
+   */
+  const char* name;
+
+  /**
+   * Prints every registered loop to the terminal.
+   */
+  static void all_print();
+
+  /**
+   * Prints every registered loop to the brain screen.
+   *
+   * \param line
+   *        first line to print on
+   */
+  static void all_screen_print(int line);
+
+  /**
+   * Resets every registered loop.
+   */
+  static void all_reset();
+
+  /**
+   * Starts a task that only wakes up on a fixed period and measures how late it
+   * wakes up.  This shows how much other tasks at this priority are being
+   * delayed, including ones that can't be measured directly.
+   *
+   * \param period
+   *        period in ms
+   * \param priority
+   *        task priority to measure at
+   */
+  static void probe_start(int period = 10, uint32_t priority = TASK_PRIORITY_DEFAULT);
+
+ private:
+  static const int BUCKETS = 256;
+  static const int BUCKET_WIDTH = 100;
+  struct histogram {
+    uint32_t counts[BUCKETS];
+    uint32_t min;
+    uint32_t max;
+    uint32_t total;
+    void add(uint32_t us);
+    void reset();
+    summary get();
+  };
+  histogram periods;
+  histogram executions;
+  uint32_t overruns = 0;
+  uint64_t last_start = 0;
+  uint64_t current_start = 0;
+  int nominal = 0;
+};
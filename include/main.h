@@ -45,7 +45,20 @@
 
 // More includes here...
 #include "autons.hpp"
+#include "battery.hpp"
+#include "benchmark.hpp"
+#include "gain_schedule.hpp"
+#include "loop_stats.hpp"
+#include "motion.hpp"
+#include "motion_profiler.hpp"
+#include "odometry.hpp"
+#include "path.hpp"
+#include "path_cache.hpp"
+#include "path_compiled.hpp"
 #include "subsystems.hpp"
+#include "sysid.hpp"
+#include "timeline.hpp"
+#include "trajectory.hpp"
 
 
 /**
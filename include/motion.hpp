@@ -0,0 +1,854 @@
+#pragma once
+
+#include "EZ-Template/api.hpp"
+#include "battery.hpp"
+#include "gain_schedule.hpp"
+#include "loop_stats.hpp"
+#include "motion_profile.hpp"
+#include "path.hpp"
+#include "trajectory.hpp"
+
+/**
+ * Project-owned drive control task.
+ *
+ * EZ-Template's drive task runs at a fixed ez::util::DELAY_TIME.  Motions started
+ * through this namespace run in their own task instead, at a rate set with
+ * rate_set(), and each period is scheduled from the last wake up time so the
+ * loop doesn't drift.
+ *
+ * While one of these motions is running EZ-Template's PID is disabled.  Calling
+ * any chassis.pid_*_set() hands the drive back to EZ-Template.
+ */
+namespace motion {
+/**
+ * How many motions can wait in the queue behind the running one.
+ */
+const int QUEUE_SIZE = 16;
+
+/**
+ * A motion that runs in the motion task.
+ */
+class Controller {
+ public:
+  virtual ~Controller() = default;
+
+  /**
+   * Does everything that doesn't need live sensor values: targets, constants,
+   * slew and path processing.  For queued motions this runs while the motion
+   * ahead of it is still running.
+   *
+   * \param heading
+   *        the heading the robot is expected to have when this motion starts
+   *
+   * Returns the heading the robot is expected to have when this motion ends.
+   */
+  virtual double prepare(double heading) { return heading; }
+
+  /**
+   * Runs in the motion task right before the first iterate().  Read sensors here.
+   */
+  virtual void start() {}
+
+  /**
+   * Runs every period.  Sets the drive and returns RUNNING until the motion has
+   * exited.  This keeps being called after it exits so the robot holds its target.
+   *
+   * \param dt
+   *        period in seconds
+   */
+  virtual ez::exit_output iterate(double dt) = 0;
+
+  /**
+   * Returns the closest EZ-Template mode to this motion.
+   */
+  virtual ez::e_mode mode_get() = 0;
+
+  /**
+   * Returns the target of this motion, inches or degrees depending on the motion.
+   */
+  virtual double target_get() { return 0.0; }
+
+  /**
+   * Returns how far this motion is from its target.
+   */
+  virtual double error_get() { return 0.0; }
+
+  /**
+   * Returns how long this motion is expected to take in seconds, or 0 if it
+   * can't tell ahead of time.
+   */
+  virtual double duration_predicted_get() { return 0.0; }
+
+  /**
+   * Returns the index of the input path point this motion is going to, the
+   * index of the sample being tracked for trajectories, or -1 if it doesn't
+   * follow a path.
+   */
+  virtual int path_index_get() { return -1; }
+};
+
+/**
+ * Starts the motion task.  Run this in initialize().
+ */
+void initialize();
+
+/**
+ * Sets how often the motion task runs.
+ *
+ * The period is rounded to a whole ms, and the change applies to the next motion.
+ *
+ * \param hz
+ *        loops per second, 1 to 1000
+ */
+void rate_set(int hz);
+
+/**
+ * Returns how often the motion task runs in loops per second.
+ */
+int rate_get();
+
+/**
+ * Returns the period of the motion task in ms.
+ */
+int period_get();
+
+/**
+ * Returns true if the motion task is running, holding or has queued a motion.
+ *
+ * \param controller
+ *        the motion to look for
+ */
+bool in_use(const Controller* controller);
+
+/**
+ * Rotating storage for controllers so starting or queueing a motion never
+ * allocates.  There are enough for a full queue, the running motion and the
+ * one being set up.
+ */
+template <typename T>
+class Pool {
+ public:
+  /**
+   * Returns a slot the motion task isn't using.  At most QUEUE_SIZE + 1 are in
+   * use, so there's always one, even after queueing fails on a full queue.
+   */
+  T* get() {
+    T* out;
+    do {
+      out = &items[next];
+      next = (next + 1) % (QUEUE_SIZE + 2);
+    } while (in_use(out));
+    return out;
+  }
+
+ private:
+  T items[QUEUE_SIZE + 2];
+  int next = 0;
+};
+
+/**
+ * Prepares and starts a motion right away, clearing the queue.  The motion task
+ * calls it until another motion starts.
+ *
+ * \param controller
+ *        the motion to run, this must stay alive while it runs
+ */
+void start(Controller* controller);
+
+/**
+ * Prepares a motion and adds it to the queue.  When the motion ahead of it
+ * exits, the motion task starts this one in the same tick.
+ *
+ * If nothing is running this starts the motion right away.  Returns false if
+ * the queue is full.
+ *
+ * \param controller
+ *        the motion to run, this must stay alive while it runs
+ */
+bool queue(Controller* controller);
+
+/**
+ * Returns the motion the motion task is running, or nullptr.  This stays set
+ * after the motion exits while it holds its target.
+ */
+Controller* current_get();
+
+/**
+ * Returns path_index_get() of the current motion, or -1 if there isn't one.
+ *
+ * This reads it under the motion lock, so other tasks can call it without
+ * racing the motion task or reading a path that's been released.
+ */
+int path_index_get();
+
+/**
+ * Returns how many motions are waiting behind the running one.
+ */
+int queue_amount_get();
+
+/**
+ * Sets the drive, scaled for the battery when battery compensation is on.
+ * Controllers should set the drive through this.
+ *
+ * \param left
+ *        left side output, -127 to 127
+ * \param right
+ *        right side output, -127 to 127
+ */
+void drive_set(double left, double right);
+
+/**
+ * Stops the current motion and clears the queue, without touching the drive.
+ *
+ * Once this returns the motion task doesn't read any motion that was running,
+ * held or queued, so the paths and trajectories they were given can be
+ * rewritten.  The drive keeps its last output until the next motion starts.
+ */
+void release();
+
+/**
+ * Stops the current motion, clears the queue and sets the drive to 0.
+ */
+void stop();
+
+/**
+ * Returns true if a motion is running and hasn't exited yet, or motions are queued.
+ */
+bool running();
+
+/**
+ * Returns how the current motion exited, or RUNNING.
+ */
+ez::exit_output exit_get();
+
+/**
+ * Blocks until the current motion and everything queued behind it exits, and
+ * returns how the last one exited.
+ *
+ * The motion task wakes the waiting task with a task notification as soon as
+ * the exit is decided, so there's no polling delay.  Only one task can wait at
+ * a time.  Returns RUNNING if the motion was stopped or EZ-Template took the
+ * drive back before it exited.
+ */
+ez::exit_output wait();
+
+/**
+ * Copies constants and exit conditions from an EZ-Template PID, rescaled for the
+ * motion task period.
+ *
+ * ez::PID counts its exit timers in steps of ez::util::DELAY_TIME and its I and
+ * D terms per call.  This rescales times, kI, kD and the velocity exit
+ * thresholds so the PID behaves the same in real time at any rate.
+ *
+ * \param pid
+ *        the PID to set up
+ * \param source
+ *        the PID to copy from
+ * \param constants
+ *        constants to use, these are usually a forward or backward set of the source
+ */
+void pid_scaled_set(ez::PID& pid, ez::PID& source, ez::PID::Constants constants);
+
+/**
+ * Sets constants on a PID rescaled for the motion task period, without
+ * resetting anything.  This is cheap enough to run every loop.
+ *
+ * \param pid
+ *        the PID to set
+ * \param constants
+ *        constants as they'd be given to EZ-Template
+ */
+void pid_constants_scaled_set(ez::PID& pid, ez::PID::Constants constants);
+
+/**
+ * Sets the gain schedule for drives.  An empty schedule uses the chassis constants.
+ *
+ * Distance and speed schedules are looked up once when the motion is prepared,
+ * error schedules are looked up every loop.
+ *
+ * \param schedule
+ *        constants by distance in inches, error in inches or speed
+ */
+void drive_gain_schedule_set(const GainSchedule& schedule);
+
+/**
+ * Returns the gain schedule for drives.
+ */
+const GainSchedule& drive_gain_schedule_get();
+
+/**
+ * Sets the gain schedule for turns.  An empty schedule uses the chassis constants.
+ *
+ * \param schedule
+ *        constants by distance in degrees, error in degrees or speed
+ */
+void turn_gain_schedule_set(const GainSchedule& schedule);
+
+/**
+ * Returns the gain schedule for turns.
+ */
+const GainSchedule& turn_gain_schedule_get();
+
+/**
+ * Sets the gain schedule for swings.  An empty schedule uses the chassis constants.
+ *
+ * \param schedule
+ *        constants by distance in degrees, error in degrees or speed
+ */
+void swing_gain_schedule_set(const GainSchedule& schedule);
+
+/**
+ * Returns the gain schedule for swings.
+ */
+const GainSchedule& swing_gain_schedule_get();
+
+/**
+ * Drives forward or backward with PID at the motion task rate.
+ *
+ * Uses the chassis drive, heading and slew constants and drive exit conditions.
+ *
+ * \param target
+ *        distance to travel
+ * \param speed
+ *        max speed, 0 to 127
+ * \param slew_on
+ *        ramp up from the slew min speed
+ */
+void pid_drive_set(okapi::QLength target, int speed, bool slew_on = false);
+
+/**
+ * Turns in place with PID at the motion task rate.
+ *
+ * Uses the chassis turn constants and exit conditions.
+ *
+ * \param target
+ *        absolute angle to turn to
+ * \param speed
+ *        max speed, 0 to 127
+ * \param behavior
+ *        which way to turn, defaults to the chassis turn behavior
+ */
+void pid_turn_set(okapi::QAngle target, int speed, ez::e_angle_behavior behavior);
+void pid_turn_set(okapi::QAngle target, int speed);
+
+/**
+ * Swings with one side of the drive with PID at the motion task rate.
+ *
+ * Uses the chassis swing constants and exit conditions.
+ *
+ * \param type
+ *        ez::LEFT_SWING or ez::RIGHT_SWING
+ * \param target
+ *        absolute angle to swing to
+ * \param speed
+ *        max speed of the moving side, 0 to 127
+ * \param opposite_speed
+ *        speed of the other side, this allows for wider arcs
+ */
+void pid_swing_set(ez::e_swing type, okapi::QAngle target, int speed, int opposite_speed = 0);
+
+/**
+ * Queues a drive.  Same as pid_drive_set(), but it runs after everything queued.
+ */
+bool queue_drive(okapi::QLength target, int speed, bool slew_on = false);
+
+/**
+ * Queues a turn.  Same as pid_turn_set(), but it runs after everything queued.
+ *
+ * The angle behavior is worked out from where the motion ahead of it ends.
+ */
+bool queue_turn(okapi::QAngle target, int speed, ez::e_angle_behavior behavior);
+bool queue_turn(okapi::QAngle target, int speed);
+
+/**
+ * Queues a swing.  Same as pid_swing_set(), but it runs after everything queued.
+ */
+bool queue_swing(ez::e_swing type, okapi::QAngle target, int speed, int opposite_speed = 0);
+
+/**
+ * Feedforward for a drive side, output out of 127.
+ */
+struct Feedforward {
+  double kS = 0.0;  // output to overcome static friction
+  double kV = 0.0;  // output per in/s
+  double kA = 0.0;  // output per in/s^2
+
+  /**
+   * Returns the output needed to hold a velocity and acceleration.
+   */
+  double compute(double velocity, double acceleration) const;
+};
+
+/**
+ * Sets the drive feedforward used by profiled motions.
+ *
+ * \param kS
+ *        output to overcome static friction
+ * \param kV
+ *        output per in/s
+ * \param kA
+ *        output per in/s^2
+ */
+void drive_feedforward_set(double kS, double kV, double kA);
+
+/**
+ * Returns the drive feedforward used by profiled motions.
+ */
+Feedforward drive_feedforward_get();
+
+/**
+ * Sets the PID constants that correct what feedforward misses in profiled drives.
+ *
+ * The error is how far each side is behind where the profile says it should be.
+ *
+ * \param p
+ *        proportional term
+ * \param i
+ *        integral term
+ * \param d
+ *        derivative term
+ * \param start_i
+ *        inches behind or ahead of the profile the integral starts building up inside of
+ */
+void pid_profiled_drive_constants_set(double p, double i = 0.0, double d = 0.0, double start_i = 2.0);
+
+/**
+ * Sets the limits profiled drives use when a motion doesn't give its own.
+ *
+ * \param limits
+ *        velocity in in/s, acceleration in in/s^2 and jerk in in/s^3, a jerk of 0 is a trapezoid
+ */
+void profiled_drive_constraints_set(MotionProfile::constraints limits);
+
+/**
+ * Returns the limits profiled drives use when a motion doesn't give its own.
+ */
+MotionProfile::constraints profiled_drive_constraints_get();
+
+/**
+ * Drives forward or backward following a motion profile.
+ *
+ * Each side tracks the profile with feedforward plus PID on what's left over,
+ * and the chassis heading constants hold the robot straight.  Once the profile
+ * ends this uses the chassis drive exit conditions.
+ *
+ * \param target
+ *        distance to travel
+ * \param limits
+ *        velocity in in/s, acceleration in in/s^2 and jerk in in/s^3, a jerk of 0 is a trapezoid
+ */
+void pid_profiled_drive_set(okapi::QLength target, MotionProfile::constraints limits);
+void pid_profiled_drive_set(okapi::QLength target);
+
+/**
+ * Queues a profiled drive.  Same as pid_profiled_drive_set(), but it runs after everything queued.
+ */
+bool queue_profiled_drive(okapi::QLength target, MotionProfile::constraints limits);
+bool queue_profiled_drive(okapi::QLength target);
+
+/**
+ * Sets the feedforward used by profiled turns.
+ *
+ * \param kS
+ *        output to overcome static friction
+ * \param kV
+ *        output per deg/s
+ * \param kA
+ *        output per deg/s^2
+ */
+void turn_feedforward_set(double kS, double kV, double kA);
+
+/**
+ * Returns the feedforward used by profiled turns.
+ */
+Feedforward turn_feedforward_get();
+
+/**
+ * Sets the feedforward used by profiled swings.  Only one side is driven, so
+ * these are usually about twice the turn constants.
+ *
+ * \param kS
+ *        output to overcome static friction
+ * \param kV
+ *        output per deg/s
+ * \param kA
+ *        output per deg/s^2
+ */
+void swing_feedforward_set(double kS, double kV, double kA);
+
+/**
+ * Returns the feedforward used by profiled swings.
+ */
+Feedforward swing_feedforward_get();
+
+/**
+ * Sets the constants that correct what feedforward misses in profiled turns.
+ *
+ * \param p
+ *        output per degree the robot is behind the profile
+ * \param d
+ *        output per deg/s the robot is behind the profile, measured with the IMU's gyro
+ */
+void pid_profiled_turn_constants_set(double p, double d);
+
+/**
+ * Sets the constants that correct what feedforward misses in profiled swings.
+ *
+ * \param p
+ *        output per degree the robot is behind the profile
+ * \param d
+ *        output per deg/s the robot is behind the profile, measured with the IMU's gyro
+ */
+void pid_profiled_swing_constants_set(double p, double d);
+
+/**
+ * Sets the limits profiled turns use when a motion doesn't give its own.
+ *
+ * \param limits
+ *        velocity in deg/s, acceleration in deg/s^2 and jerk in deg/s^3, a jerk of 0 is a trapezoid
+ */
+void profiled_turn_constraints_set(MotionProfile::constraints limits);
+
+/**
+ * Returns the limits profiled turns use when a motion doesn't give its own.
+ */
+MotionProfile::constraints profiled_turn_constraints_get();
+
+/**
+ * Sets the limits profiled swings use when a motion doesn't give its own.
+ *
+ * \param limits
+ *        velocity in deg/s, acceleration in deg/s^2 and jerk in deg/s^3, a jerk of 0 is a trapezoid
+ */
+void profiled_swing_constraints_set(MotionProfile::constraints limits);
+
+/**
+ * Returns the limits profiled swings use when a motion doesn't give its own.
+ */
+MotionProfile::constraints profiled_swing_constraints_get();
+
+/**
+ * Sets if turns and swings that don't pick should be profiled.
+ *
+ * This doesn't change anything here, it's for helpers that run either kind of
+ * motion, like turn() in autons.cpp.
+ *
+ * \param toggle
+ *        true to profile turns and swings by default
+ */
+void profiled_turn_toggle(bool toggle);
+
+/**
+ * Returns true if turns and swings should be profiled by default.
+ */
+bool profiled_turn_enabled();
+
+/**
+ * Turns in place following a motion profile.
+ *
+ * Tracks the profile with feedforward plus correction on the heading and the
+ * gyro rate.  Once the profile ends this uses the chassis turn exit conditions.
+ *
+ * \param target
+ *        absolute angle to turn to
+ * \param limits
+ *        velocity in deg/s, acceleration in deg/s^2 and jerk in deg/s^3, a jerk of 0 is a trapezoid
+ * \param behavior
+ *        which way to turn, defaults to the chassis turn behavior
+ */
+void pid_profiled_turn_set(okapi::QAngle target, MotionProfile::constraints limits, ez::e_angle_behavior behavior);
+void pid_profiled_turn_set(okapi::QAngle target, MotionProfile::constraints limits);
+void pid_profiled_turn_set(okapi::QAngle target);
+
+/**
+ * Swings with one side of the drive following a motion profile.
+ *
+ * Once the profile ends this uses the chassis swing exit conditions.
+ *
+ * \param type
+ *        ez::LEFT_SWING or ez::RIGHT_SWING
+ * \param target
+ *        absolute angle to swing to
+ * \param limits
+ *        velocity in deg/s, acceleration in deg/s^2 and jerk in deg/s^3, a jerk of 0 is a trapezoid
+ */
+void pid_profiled_swing_set(ez::e_swing type, okapi::QAngle target, MotionProfile::constraints limits);
+void pid_profiled_swing_set(ez::e_swing type, okapi::QAngle target);
+
+/**
+ * Queues a profiled turn.  Same as pid_profiled_turn_set(), but it runs after everything queued.
+ */
+bool queue_profiled_turn(okapi::QAngle target, MotionProfile::constraints limits, ez::e_angle_behavior behavior);
+bool queue_profiled_turn(okapi::QAngle target, MotionProfile::constraints limits);
+bool queue_profiled_turn(okapi::QAngle target);
+
+/**
+ * Queues a profiled swing.  Same as pid_profiled_swing_set(), but it runs after everything queued.
+ */
+bool queue_profiled_swing(ez::e_swing type, okapi::QAngle target, MotionProfile::constraints limits);
+bool queue_profiled_swing(ez::e_swing type, okapi::QAngle target);
+
+/**
+ * Sets the constants paths are smoothed with.
+ *
+ * \param weight_smooth
+ *        how much each point is pulled toward its neighbors
+ * \param weight_data
+ *        how much each point is pulled back to where it started
+ * \param tolerance
+ *        stop once a pass moves the points less than this
+ */
+void path_smooth_constants_set(double weight_smooth, double weight_data, double tolerance);
+
+/**
+ * Smooths a path in place with the constants from path_smooth_constants_set().
+ *
+ * \param path
+ *        path to smooth
+ */
+void path_smooth(Path& path);
+
+/**
+ * Constants for adaptive pure pursuit.
+ */
+struct PurePursuitAdaptive {
+  double look_ahead_min = 4.0;         // in, look ahead while stopped
+  double look_ahead_max = 14.0;        // in
+  double look_ahead_time = 0.2;        // s, look ahead grows by how far the robot goes in this long
+  double lateral_acceleration = 60.0;  // in/s^2, most sideways acceleration allowed in corners
+  double deceleration = 100.0;         // in/s^2, how hard the robot can slow down for a corner
+};
+
+/**
+ * Sets the constants for adaptive pure pursuit.
+ *
+ * \param constants
+ *        look ahead and speed limits
+ */
+void pp_adaptive_constants_set(PurePursuitAdaptive constants);
+
+/**
+ * Returns the constants for adaptive pure pursuit.
+ */
+PurePursuitAdaptive pp_adaptive_constants_get();
+
+/**
+ * Sets if pure pursuit adapts to the robot's speed and the path's curvature.
+ *
+ * When this is on the look ahead grows with the measured speed, between the min
+ * and max in pp_adaptive_constants_set(), in place of the chassis look ahead.
+ * Each point's speed is also capped so the robot corners within the lateral
+ * acceleration limit.  Corners ahead are seen early enough to slow down for
+ * them at the deceleration limit.
+ *
+ * Speeds in in/s become output with the drive feedforward, so it has to be
+ * set with drive_feedforward_set() for the speed caps to do anything.
+ *
+ * \param toggle
+ *        true to adapt, false to use the chassis look ahead and point speeds
+ */
+void pp_adaptive_toggle(bool toggle);
+
+/**
+ * Returns true if pure pursuit adapts to speed and curvature.
+ */
+bool pp_adaptive_enabled();
+
+/**
+ * Follows a path with pure pursuit at the motion task rate.
+ *
+ * The path isn't copied.  It's in use for as long as the motion is running,
+ * queued or holding its target after it exits, which lasts until another
+ * motion starts or release() or stop() is called.  It has to stay alive and
+ * unchanged until then.  Uses the chassis look ahead, turn bias, odom angular constants,
+ * drive constants and odom drive exit conditions.  Nothing here allocates.
+ *
+ * Each loop only searches twice the look ahead worth of points past the last
+ * closest point, so long paths with tight spacing cost the same as short ones.
+ * If the robot gets pushed further than the look ahead from all of them, the
+ * whole path is searched once to find it again.  Another part of the path only
+ * wins if it's closer than the part the robot was on by the look ahead, and
+ * until the robot is back within half the look ahead the closest point moves
+ * one point at a time either way.
+ *
+ * \param path
+ *        an already built path
+ */
+void pid_odom_pp_set(const Path& path);
+
+/**
+ * Builds a path from the robot's pose through the input points, injecting
+ * points at the chassis path spacing, then follows it.  Returns false if the
+ * path doesn't fit in the storage or the storage is a read only path.
+ *
+ * The current motion is released before the storage is written, so the storage
+ * the last motion is following can be reused.  The storage is in use the same
+ * way as in pid_odom_pp_set().
+ *
+ * \param storage
+ *        where the path is built, this has to stay alive while the motion is in use
+ * \param input
+ *        points to go through
+ */
+bool pid_odom_injected_pp_set(Path& storage, std::span<const ez::odom> input);
+bool pid_odom_injected_pp_set(Path& storage, std::initializer_list<ez::odom> input);
+
+/**
+ * Same as pid_odom_injected_pp_set(), but the path is smoothed too.
+ *
+ * \param storage
+ *        where the path is built, this has to stay alive while the motion is in use
+ * \param input
+ *        points to go through
+ */
+bool pid_odom_smooth_pp_set(Path& storage, std::span<const ez::odom> input);
+bool pid_odom_smooth_pp_set(Path& storage, std::initializer_list<ez::odom> input);
+
+/**
+ * Same as pid_odom_injected_pp_set(), but the path is a spline through the
+ * input points.  See Path::build_spline().
+ *
+ * \param storage
+ *        where the path is built, this has to stay alive while the motion is in use
+ * \param input
+ *        points to go through
+ */
+bool pid_odom_spline_pp_set(Path& storage, std::span<const ez::odom> input);
+bool pid_odom_spline_pp_set(Path& storage, std::initializer_list<ez::odom> input);
+
+/**
+ * Queues a pure pursuit.  Same as pid_odom_pp_set(), but it runs after everything queued.
+ *
+ * The robot's pose isn't known ahead of time, so the path should start where
+ * the motion ahead of it ends.
+ */
+bool queue_odom_pp(const Path& path);
+
+/**
+ * Follows a path from the path cache.  Returns false if the ID hasn't been built.
+ *
+ * \param path_id
+ *        ID the path was registered with in paths::add()
+ */
+bool pid_odom_pp_set(int path_id);
+
+/**
+ * Queues a path from the path cache.  Returns false if the ID hasn't been
+ * built or the queue is full.
+ *
+ * \param path_id
+ *        ID the path was registered with in paths::add()
+ */
+bool queue_odom_pp(int path_id);
+
+/**
+ * Sets the RAMSETE constants trajectories are followed with.
+ *
+ * These are unitless the way they're usually given, for meters and radians,
+ * so the common 2.0 and 0.7 work as is.
+ *
+ * \param b
+ *        how hard to pull back onto the trajectory, higher is more aggressive
+ * \param zeta
+ *        damping, 0 to 1
+ * \param velocity_p
+ *        output per in/s each side is behind the speed it should be going, this
+ *        catches what the drive feedforward misses
+ */
+void ramsete_constants_set(double b, double zeta, double velocity_p = 0.0);
+
+/**
+ * Follows a trajectory with RAMSETE at the motion task rate.
+ *
+ * Every loop the reference is sampled by the clock, RAMSETE turns the pose
+ * error into a corrected speed and turn rate, and each side is driven with the
+ * drive feedforward at the wheel speeds that gives, plus P on each side's
+ * measured speed.  The motion takes as long
+ * as the trajectory says, which duration_predicted_get() and the profiler
+ * report.  Once it's over this uses the odom drive exit conditions.
+ *
+ * The trajectory isn't copied, it's in use the same way a path is in
+ * pid_odom_pp_set().  path_index_get() is the index of the point being tracked.
+ *
+ * \param trajectory
+ *        timed points to follow, the first should be where the robot is
+ */
+void pid_odom_trajectory_set(const Trajectory& trajectory);
+
+/**
+ * Queues a trajectory.  Same as pid_odom_trajectory_set(), but it runs after everything queued.
+ */
+bool queue_odom_trajectory(const Trajectory& trajectory);
+
+/**
+ * Sets the limits spline trajectories are generated with.
+ *
+ * \param limits
+ *        velocity in in/s, acceleration in in/s^2 and jerk in in/s^3, a jerk of 0 isn't limited
+ */
+void spline_constraints_set(MotionProfile::constraints limits);
+
+/**
+ * Returns the limits spline trajectories are generated with.
+ */
+MotionProfile::constraints spline_constraints_get();
+
+/**
+ * Generates a quintic spline trajectory with okapi's squiggles.
+ *
+ * The spline goes through every waypoint at its heading, waypoints without a
+ * heading face the next one.  Speeds are limited by the spline constraints and
+ * by a tank model at the chassis drive width, so the outside wheel never goes
+ * faster than the velocity limit in corners.  Trajectories only drive forward.
+ *
+ * This allocates and can take a while for long trajectories, so do it in
+ * initialize() and follow the result with pid_odom_trajectory_set().  Returns
+ * false if squiggles can't find a trajectory, throws or the storage is too
+ * small, the trajectory is empty then.
+ *
+ * \param storage
+ *        where the trajectory is built
+ * \param start
+ *        where the trajectory starts
+ * \param waypoints
+ *        poses to go through
+ */
+bool spline_generate(Trajectory& storage, ez::pose start, std::span<const ez::united_pose> waypoints);
+
+/**
+ * Generates a spline trajectory from the robot's pose through waypoints and
+ * follows it.  See spline_generate() and pid_odom_trajectory_set().
+ *
+ * Squiggles runs before the motion starts, on the caller's task, so the robot
+ * sits still while it works.  In a match, generate trajectories with
+ * spline_generate() in initialize() instead.  Returns false and doesn't start a
+ * motion if the trajectory can't be generated.
+ *
+ * The current motion is released before the storage is written, like
+ * pid_odom_injected_pp_set().
+ *
+ * \param storage
+ *        where the trajectory is built, this has to stay alive while the motion is in use
+ * \param waypoints
+ *        poses to go through
+ */
+bool pid_odom_spline_set(Trajectory& storage, std::span<const ez::united_pose> waypoints);
+bool pid_odom_spline_set(Trajectory& storage, std::initializer_list<ez::united_pose> waypoints);
+
+/**
+ * Returns the turn target after applying an angle behavior.
+ *
+ * \param target
+ *        absolute target in degrees
+ * \param current
+ *        current angle in degrees
+ * \param behavior
+ *        which way to turn
+ */
+double angle_target_get(double target, double current, ez::e_angle_behavior behavior);
+
+/**
+ * Timing of the motion task.
+ */
+extern LoopStats stats;
+}  // namespace motion
@@ -0,0 +1,86 @@
+#pragma once
+
+/**
+ * One dimensional motion profile from rest to rest.
+ *
+ * With a jerk limit this is a 7 segment S-curve, without one it's a trapezoid.
+ * If the distance is too short to reach the velocity or acceleration limits,
+ * the peak velocity is lowered until it fits.  Units are whatever the
+ * constraints are given in, inches or degrees and seconds.
+ *
+ * This doesn't touch any devices.
+ */
+class MotionProfile {
+ public:
+  /**
+   * Limits for the profile.  A jerk of 0 makes a trapezoid.
+   */
+  struct constraints {
+    double velocity;
+    double acceleration;
+    double jerk = 0.0;
+  };
+
+  /**
+   * Position, velocity and acceleration at a point in time.
+   */
+  struct state {
+    double position;
+    double velocity;
+    double acceleration;
+  };
+
+  MotionProfile();
+
+  /**
+   * Generates a profile.
+   *
+   * \param distance
+   *        distance to travel, negative goes backward
+   * \param limits
+   *        velocity, acceleration and jerk limits, all positive
+   */
+  MotionProfile(double distance, constraints limits);
+
+  /**
+   * Generates a profile.
+   *
+   * \param distance
+   *        distance to travel, negative goes backward
+   * \param limits
+   *        velocity, acceleration and jerk limits, all positive
+   */
+  void generate(double distance, constraints limits);
+
+  /**
+   * Returns where the profile is at a time.  Times past the end hold the end.
+   *
+   * \param t
+   *        seconds since the start of the profile
+   */
+  state sample(double t);
+
+  /**
+   * Returns how long the profile takes in seconds.
+   */
+  double duration();
+
+  /**
+   * Returns the distance the profile travels.
+   */
+  double distance();
+
+ private:
+  struct segment {
+    double start;  // time the segment starts
+    double jerk;
+    state begin;
+  };
+  static const int MAX_SEGMENTS = 7;
+  segment segments[MAX_SEGMENTS];
+  int amount = 0;
+  double total_time = 0.0;
+  double total_distance = 0.0;
+  int sign = 1;
+  void segment_add(double duration, double acceleration, double jerk, state* current, double* t);
+};
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <source_location>
+
+#include "EZ-Template/api.hpp"
+#include "motion.hpp"
+
+/**
+ * Records how long every autonomous motion takes and why it ended.
+ *
+ * Use these in place of chassis.pid_wait(), chassis.pid_wait_quick_chain() and
+ * chassis.pid_wait_until().  The line each wait was called from is recorded so
+ * motions can be traced back to autons.cpp.
+ */
+namespace profiler {
+/**
+ * One recorded motion.
+ */
+struct motion {
+  int line;
+  ez::e_mode mode;
+  double target;  // distance for drives, the target heading or position otherwise
+  double error;
+  ez::exit_output exit;
+  bool exit_inferred;  // EZ-Template doesn't say why it exited, so exit is a guess from the final error
+  bool chained;
+  uint32_t start;
+  uint32_t end;
+  uint32_t predicted;  // ms, 0 if the motion couldn't tell ahead of time
+};
+
+/**
+ * Clears all recorded motions and starts the auton clock.
+ */
+void reset();
+
+/**
+ * Wraps chassis.pid_wait() and records the motion.
+ */
+void wait(std::source_location loc = std::source_location::current());
+
+/**
+ * Wraps chassis.pid_wait_quick_chain() and records the motion.
+ */
+void wait_quick_chain(std::source_location loc = std::source_location::current());
+
+/**
+ * Wraps motion::wait() and records the motion.
+ *
+ * Profiled motions also record how long they were expected to take.  If motions
+ * are queued they're recorded together as the one running when this is called.
+ */
+void motion_wait(std::source_location loc = std::source_location::current());
+
+/**
+ * Wraps chassis.pid_wait_until().  The motion stays open until the next wait.
+ *
+ * \param target
+ *        distance to wait until
+ */
+void wait_until(okapi::QLength target, std::source_location loc = std::source_location::current());
+
+/**
+ * Wraps chassis.pid_wait_until().  The motion stays open until the next wait.
+ *
+ * \param target
+ *        angle to wait until
+ */
+void wait_until(okapi::QAngle target, std::source_location loc = std::source_location::current());
+
+/**
+ * Wraps chassis.pid_wait_until().  The motion stays open until the next wait.
+ *
+ * \param target
+ *        value to wait until, inches or degrees depending on the motion
+ */
+void wait_until(double target, std::source_location loc = std::source_location::current());
+
+/**
+ * Returns the amount of recorded motions.
+ */
+int motions_amount();
+
+/**
+ * Returns a recorded motion.
+ *
+ * \param index
+ *        the order the motion ran in, starting at 0
+ */
+motion motion_get(int index);
+
+/**
+ * Prints every motion ranked by how long it took, and where the rest of the
+ * auton went.
+ */
+void report_print();
+}  // namespace profiler
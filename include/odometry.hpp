@@ -0,0 +1,143 @@
+#pragma once
+
+#include "EZ-Template/util.hpp"
+#include "loop_stats.hpp"
+
+/**
+ * Pose tracking in its own high priority task.
+ *
+ * EZ-Template integrates odometry in its tracking task every
+ * ez::util::DELAY_TIME, alongside its PID.  This runs a second integrator at
+ * a rate set with rate_set(), at the highest task priority, so motions in the
+ * motion task read a pose that's at most one short period old.
+ *
+ * It reads the same sensors EZ-Template does: the drive sensors (the parallel
+ * tracking wheels if there are two), the back or front tracking wheel and the
+ * IMU.  EZ-Template's own tracking keeps running, so chassis.odom_pose_get()
+ * still works for EZ-Template's motions.  Rotation sensors only report every
+ * 10ms unless their data rate is set lower, see main.cpp.
+ */
+namespace odometry {
+/**
+ * Starts the odometry task from EZ-Template's current pose.  Run this in
+ * initialize() after chassis.initialize().
+ */
+void initialize();
+
+/**
+ * Sets how often the odometry task runs.
+ *
+ * \param hz
+ *        loops per second, 1 to 1000
+ */
+void rate_set(int hz);
+
+/**
+ * Returns how often the odometry task runs in loops per second.
+ */
+int rate_get();
+
+/**
+ * Returns the newest pose.  Before initialize() this is EZ-Template's pose.
+ */
+ez::pose pose_get();
+
+/**
+ * Sets the pose here and in EZ-Template.  Call this after resetting the drive
+ * sensors or IMU, the next loop measures from their new values.
+ *
+ * \param pose
+ *        where the robot is, inches and degrees
+ */
+void pose_set(ez::pose pose);
+
+/**
+ * Ways to move the pose by what the sensors measured over one loop.
+ */
+enum e_integrator {
+  EULER = 0,        // straight line along the heading at the start of the loop
+  ARC = 1,          // EZ-Template's arc to chord method, in float
+  EXPONENTIAL = 2,  // SE(2) exponential map, in double
+};
+
+/**
+ * Sets how the odometry task integrates the pose.  Defaults to EXPONENTIAL.
+ *
+ * \param method
+ *        EULER, ARC or EXPONENTIAL
+ */
+void integrator_set(e_integrator method);
+
+/**
+ * Returns how the odometry task integrates the pose.
+ */
+e_integrator integrator_get();
+
+/**
+ * Sets if the IMU heading is carried forward between IMU samples.
+ *
+ * The IMU only updates every 10ms.  When odometry runs faster than that, some
+ * loops see the wheels move but the heading stand still, and the next loop
+ * gets the whole turn at once.  With this on the heading is moved forward by
+ * the gyro rate for the time since the last new sample.  It's on by default.
+ *
+ * \param toggle
+ *        true to carry the heading forward
+ */
+void imu_interpolation_toggle(bool toggle);
+
+/**
+ * Returns true if the IMU heading is carried forward between samples.
+ */
+bool imu_interpolation_enabled();
+
+/**
+ * Moves a pose by what the robot measured over one loop.  This doesn't touch
+ * any devices, so it can be used anywhere, like the host benchmark in tools.
+ *
+ * \param method
+ *        EULER, ARC or EXPONENTIAL
+ * \param pose
+ *        pose at the start of the loop
+ * \param forward
+ *        inches the center of the robot moved forward
+ * \param right
+ *        inches the center of the robot moved right, with the tracking wheel's turning taken out
+ * \param dtheta
+ *        degrees the robot turned, clockwise
+ */
+ez::pose integrate(e_integrator method, ez::pose pose, double forward, double right, double dtheta);
+
+/**
+ * Carries an IMU heading forward between samples with the gyro rate.
+ */
+class HeadingInterpolator {
+ public:
+  /**
+   * Returns the heading now.
+   *
+   * \param heading
+   *        newest IMU heading in degrees
+   * \param rate
+   *        newest gyro rate in deg/s, clockwise
+   * \param time
+   *        now in us
+   */
+  double get(double heading, double rate, uint64_t time);
+
+  /**
+   * Forgets the last sample, the next get() returns its heading as is.
+   */
+  void reset();
+
+ private:
+  double last = 0.0;
+  uint64_t sample_time = 0;
+  bool valid = false;
+};
+
+/**
+ * Timing of the odometry task.
+ */
+extern LoopStats stats;
+}  // namespace odometry
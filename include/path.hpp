@@ -0,0 +1,172 @@
+#pragma once
+
+#include <initializer_list>
+#include <span>
+
+#include "EZ-Template/util.hpp"
+
+/**
+ * A processed path in storage the caller owns.
+ *
+ * EZ-Template's path motions take std::vector and copy it a few times while
+ * injecting and smoothing.  A Path builds the processed points straight into
+ * a fixed buffer, so making one never touches the heap.  Use PathBuffer<N> to
+ * get a Path with its own storage.
+ */
+class Path {
+ public:
+  /**
+   * One processed point.
+   */
+  struct point {
+    double x;
+    double y;
+    double x_data;  // where the point was before smoothing
+    double y_data;
+    int speed;      // max speed, 0 to 127
+    ez::drive_directions direction;
+    int index;         // the input point this point leads to
+    double curvature;  // 1/in, positive curves clockwise
+  };
+
+  /**
+   * Most points, including the start, a spline can go through.
+   */
+  static const int MAX_SPLINE_POINTS = 64;
+
+  /**
+   * Creates a path that builds into storage.
+   *
+   * \param storage
+   *        where the points go, this must stay alive as long as the path
+   * \param amount
+   *        how many points at the start of storage are already built
+   */
+  Path(std::span<point> storage, int amount = 0);
+
+  /**
+   * Creates a read only path from points that are already built, like the ones
+   * paths::compile() makes at compile time.  build(), build_spline(), smooth()
+   * and clear() leave it as it is, and the builds return false.
+   *
+   * \param points
+   *        built points, these must stay alive as long as the path
+   */
+  constexpr Path(std::span<const point> points) : points(points.data()), size(points.size()), read_only(true) {}
+
+  /**
+   * Copies input points in, injecting points every spacing inches between them.
+   * Returns false if the storage is too small, the path is empty then.  Also
+   * returns false on a read only path, which is left alone.
+   *
+   * \param input
+   *        points to go through
+   * \param spacing
+   *        inches between injected points, 0 to not inject
+   */
+  bool build(std::span<const ez::odom> input, double spacing);
+  bool build(std::initializer_list<ez::odom> input, double spacing);
+
+  /**
+   * Same as build(), but the path starts at a pose before the input points.
+   *
+   * \param start
+   *        where the path starts, usually the robot's pose
+   * \param input
+   *        points to go through
+   * \param spacing
+   *        inches between injected points, 0 to not inject
+   */
+  bool build(ez::pose start, std::span<const ez::odom> input, double spacing);
+
+  /**
+   * Builds a C2 continuous path through the input points and samples it every
+   * spacing inches.  Returns false if the storage is too small or there are
+   * too many input points, the path is empty then.
+   *
+   * This is a natural cubic spline over the distance between points, solved
+   * in one pass.  It goes through every input point exactly and curvature
+   * comes straight from the spline.  Wherever the drive direction changes the
+   * spline starts over, so reversing makes a point instead of a loop.  Returns
+   * false on a read only path, which is left alone.
+   *
+   * \param input
+   *        points to go through
+   * \param spacing
+   *        inches between points
+   */
+  bool build_spline(std::span<const ez::odom> input, double spacing);
+  bool build_spline(std::initializer_list<ez::odom> input, double spacing);
+
+  /**
+   * Same as build_spline(), but the path starts at a pose before the input points.
+   *
+   * \param start
+   *        where the path starts, usually the robot's pose
+   * \param input
+   *        points to go through
+   * \param spacing
+   *        inches between points
+   */
+  bool build_spline(ez::pose start, std::span<const ez::odom> input, double spacing);
+
+  /**
+   * Smooths the path in place.  The first and last points don't move.  Does
+   * nothing to a read only path.
+   *
+   * \param weight_smooth
+   *        how much each point is pulled toward its neighbors
+   * \param weight_data
+   *        how much each point is pulled back to where it started
+   * \param tolerance
+   *        stop once a pass moves the points less than this
+   * \param max_iterations
+   *        most passes to run
+   */
+  void smooth(double weight_smooth = 0.75, double weight_data = 0.03, double tolerance = 0.0001, int max_iterations = 500);
+
+  /**
+   * Removes every point, unless the path is read only.
+   */
+  void clear();
+
+  /**
+   * Returns how many points are in the path.
+   */
+  int amount() const;
+
+  /**
+   * Returns how many points fit in the storage.
+   */
+  int capacity() const;
+
+  /**
+   * Returns true if the path was made from built points and can't change.
+   */
+  bool read_only_get() const;
+
+  // Points only change through build(), build_spline() and smooth()
+  const point& operator[](int index) const;
+
+ private:
+  std::span<point> storage;
+  const point* points;  // storage, or read only points
+  int size = 0;
+  bool read_only = false;
+  bool point_add(double x, double y, const ez::odom& target, int index);
+  bool spline_run(const double* x, const double* y, const int* knot_input, std::span<const ez::odom> input, int first, int last, double spacing);
+};
+
+/**
+ * A path with space for N points.
+ */
+template <int N>
+class PathBuffer : public Path {
+ public:
+  PathBuffer() : Path(std::span<point>(buffer)) {}
+  PathBuffer(const PathBuffer&) = delete;
+  PathBuffer& operator=(const PathBuffer&) = delete;
+
+ private:
+  point buffer[N];
+};
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "path.hpp"
+
+/**
+ * Paths processed ahead of time.
+ *
+ * Register paths by ID when the program starts and build them in initialize()
+ * or competition_initialize().  Injecting and smoothing happen then, so during
+ * a match a cached path starts right away with motion::pid_odom_pp_set(id).
+ *
+ * Cached paths can't start from the robot's pose, so the first input point
+ * should be where the robot will be when the path starts.
+ */
+namespace paths {
+/**
+ * IDs go from 0 to MAX_PATHS - 1.
+ */
+const int MAX_PATHS = 32;
+
+/**
+ * Input points shared by every registered path.
+ */
+const int MAX_INPUT_POINTS = 256;
+
+/**
+ * Processed points shared by every cached path.
+ */
+const int MAX_POINTS = 4096;
+
+/**
+ * Registers a path to be built later.  Returns false if the ID is out of range
+ * or there's no room for the input points.
+ *
+ * \param id
+ *        ID to start the path with, 0 to MAX_PATHS - 1
+ * \param input
+ *        points to go through, starting where the robot will be
+ * \param smooth
+ *        true to smooth the path after injecting points
+ */
+bool add(int id, std::initializer_list<ez::odom> input, bool smooth = true);
+
+/**
+ * Injects and smooths every registered path that hasn't been built yet.
+ * Returns false if any path didn't fit.
+ *
+ * This uses the chassis path spacing and motion::path_smooth_constants_set(),
+ * so run it after default_constants().
+ */
+bool build();
+
+/**
+ * Throws away every built path so the next build() processes them again.  Use
+ * this after changing path spacing or smoothing constants.
+ */
+void invalidate();
+
+/**
+ * Returns a built path, or nullptr if the ID hasn't been built.
+ *
+ * \param id
+ *        ID the path was registered with
+ */
+Path* get(int id);
+
+/**
+ * Prints every cached path and how much space is left.
+ */
+void print();
+}  // namespace paths
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+#include "path.hpp"
+#include "path_math.hpp"
+
+/**
+ * Paths built by the compiler.
+ *
+ * A route declared constexpr is injected, smoothed and given curvature while
+ * the project compiles, the same way Path::build() and Path::smooth() would.
+ * The points end up in a constant array in flash, so at run time there's
+ * nothing to build and no RAM is used for them.
+ *
+ *   constexpr ez::odom route[] = {{{0, 0}, ez::fwd, 110},
+ *                                 {{0, 24}, ez::fwd, 110},
+ *                                 {{24, 48}, ez::fwd, 110}};
+ *   constexpr auto route_points = paths::compile<route, 1.0>();
+ *   constexpr Path route_path(route_points);
+ *
+ *   motion::pid_odom_pp_set(route_path);
+ *
+ * A malformed route is a compile error pointing at malformed_route().
+ */
+namespace paths {
+/**
+ * Not constexpr, so reaching it while compiling a route stops the build.
+ * Routes need speeds from 0 to 127, a spacing above 0, and at least two
+ * points that aren't on top of each other.
+ */
+void malformed_route();
+
+namespace detail {
+// Same rules as Path::build(), this only counts the points
+template <std::size_t N>
+constexpr int amount(const ez::odom (&input)[N], double spacing) {
+  if (spacing <= 0.0) malformed_route();
+  for (const ez::odom& target : input)
+    if (target.max_xy_speed < 0 || target.max_xy_speed > 127) malformed_route();
+  int out = 0;
+  path_math::inject(input[0].target.x, input[0].target.y, input, spacing, [&](double, double, int) {
+    out++;
+    return true;
+  });
+  if (out < 2) malformed_route();
+  return out;
+}
+}  // namespace detail
+
+/**
+ * Builds a route into a constant array of path points at compile time.
+ *
+ * \tparam input
+ *         constexpr array of points to go through, the path starts at the first
+ * \tparam spacing
+ *         inches between injected points
+ * \tparam smooth
+ *         true to smooth like Path::smooth(), false to only inject
+ * \tparam weight_smooth
+ *         how much each point is pulled toward its neighbors
+ * \tparam weight_data
+ *         how much each point is pulled back to where it started
+ */
+template <const auto& input, double spacing, bool smooth = true, double weight_smooth = 0.75, double weight_data = 0.03>
+consteval auto compile() {
+  constexpr int AMOUNT = detail::amount(input, spacing);
+  std::array<Path::point, AMOUNT> out{};
+  int size = 0;
+  path_math::inject(input[0].target.x, input[0].target.y, input, spacing, [&](double x, double y, int i) {
+    out[size++] = path_math::point_get(x, y, input[i], i);
+    return true;
+  });
+
+  // With Path::smooth()'s default tolerance and pass limit
+  if (smooth) path_math::smooth(out, weight_smooth, weight_data, 0.0001, 500);
+  path_math::curvature_calculate(out);
+  return out;
+}
+}  // namespace paths
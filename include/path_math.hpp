@@ -0,0 +1,129 @@
+#pragma once
+
+#include <cmath>
+#include <span>
+#include <type_traits>
+
+#include "path.hpp"
+
+/**
+ * Injection, smoothing and curvature for path points.
+ *
+ * Path uses these at run time and paths::compile() uses them while the project
+ * compiles, so a path comes out the same either way.
+ */
+namespace path_math {
+constexpr double abs(double x) { return x < 0.0 ? -x : x; }
+
+// std::sqrt isn't constexpr yet, while compiling this is Newton's method from above, which always converges
+constexpr double sqrt(double x) {
+  if (!std::is_constant_evaluated()) return std::sqrt(x);
+  if (x <= 0.0) return 0.0;
+  double root = x > 1.0 ? x : 1.0;
+  for (int i = 0; i < 128; i++) {
+    double next = 0.5 * (root + x / root);
+    if (next >= root) break;
+    root = next;
+  }
+  return root;
+}
+
+constexpr double hypot(double x, double y) { return sqrt(x * x + y * y); }
+
+/**
+ * Returns an unsmoothed path point.
+ *
+ * \param x
+ *        in
+ * \param y
+ *        in
+ * \param target
+ *        the input point this point leads to
+ * \param index
+ *        index of target in the input
+ */
+constexpr Path::point point_get(double x, double y, const ez::odom& target, int index) {
+  return {x, y, x, y, target.max_xy_speed, target.drive_direction, index, 0.0};
+}
+
+/**
+ * Injects points every spacing inches from a start through each input point,
+ * and passes each one to add(x, y, index) with the index of the input point it
+ * leads to.  Segments 0 long are skipped.  Stops and returns false as soon as
+ * add() returns false.
+ *
+ * \param x
+ *        where the path starts
+ * \param y
+ *        where the path starts
+ * \param input
+ *        points to go through
+ * \param spacing
+ *        inches between injected points, 0 to not inject
+ * \param add
+ *        takes each point, returns false to stop
+ */
+template <typename F>
+constexpr bool inject(double x, double y, std::span<const ez::odom> input, double spacing, F&& add) {
+  if (input.empty()) return true;
+  for (int i = 0; i < (int)input.size(); i++) {
+    double dx = input[i].target.x - x;
+    double dy = input[i].target.y - y;
+    double length = hypot(dx, dy);
+    if (length < 1e-9) continue;
+
+    // Fill the segment up to, but not including, its end, then add the end exactly
+    int injected = spacing > 0.0 ? (int)(length / spacing) : 0;
+    if (injected > 0 && injected * spacing >= length - 1e-9) injected--;
+    for (int j = 0; j <= injected; j++) {
+      double t = j * spacing / length;
+      if (!add(x + dx * t, y + dy * t, i)) return false;
+    }
+    x = input[i].target.x;
+    y = input[i].target.y;
+  }
+  return add(x, y, (int)input.size() - 1);
+}
+
+/**
+ * Smooths points in place.  The first and last points don't move.  See
+ * Path::smooth().
+ */
+constexpr void smooth(std::span<Path::point> points, double weight_smooth, double weight_data, double tolerance, int max_iterations) {
+  int size = points.size();
+  for (int iteration = 0; iteration < max_iterations; iteration++) {
+    double change = 0.0;
+    for (int i = 1; i < size - 1; i++) {
+      Path::point& p = points[i];
+      double x = p.x, y = p.y;
+      p.x += weight_data * (p.x_data - p.x) + weight_smooth * (points[i - 1].x + points[i + 1].x - 2.0 * p.x);
+      p.y += weight_data * (p.y_data - p.y) + weight_smooth * (points[i - 1].y + points[i + 1].y - 2.0 * p.y);
+      change += abs(x - p.x) + abs(y - p.y);
+    }
+    if (change < tolerance) break;
+  }
+}
+
+/**
+ * Returns the curvature of the circle through three points in 1/in, positive
+ * curves clockwise.  Points on a line, or on top of each other, return 0.
+ */
+constexpr double curvature_get(const Path::point& a, const Path::point& b, const Path::point& c) {
+  double cross = (b.x - a.x) * (c.y - b.y) - (b.y - a.y) * (c.x - b.x);
+  double lengths = hypot(b.x - a.x, b.y - a.y) * hypot(c.x - b.x, c.y - b.y) * hypot(c.x - a.x, c.y - a.y);
+  return lengths > 1e-12 ? -2.0 * cross / lengths : 0.0;
+}
+
+/**
+ * Sets the curvature of every point from it and its neighbors.  The ends copy
+ * the points next to them.
+ */
+constexpr void curvature_calculate(std::span<Path::point> points) {
+  int size = points.size();
+  for (int i = 1; i < size - 1; i++) points[i].curvature = curvature_get(points[i - 1], points[i], points[i + 1]);
+  if (size > 1) {
+    points[0].curvature = points[1].curvature;
+    points[size - 1].curvature = points[size - 2].curvature;
+  }
+}
+}  // namespace path_math
@@ -1,6 +1,7 @@
 #pragma once
 #include "EZ-Template/api.hpp"
 #include "api.h"
+#include "battery.hpp"
 
 extern Drive chassis;
 
@@ -8,9 +9,10 @@ extern Drive chassis;
 
 // inline pros::Motor intake(1);
 // inline pros::adi::DigitalIn limit_switch('A');
-    inline pros::Motor intake(6);
-    inline pros::Motor combine(4);
-    inline pros::Motor hood(3);
+    // Mechanism outputs are scaled for the battery when battery::compensation_toggle() is on
+    inline battery::CompensatedMotor intake(6);
+    inline battery::CompensatedMotor combine(4);
+    inline battery::CompensatedMotor hood(3);
     inline pros::adi::Pneumatics block_collector('A', false); // Pneumatic for the block collector
     inline pros::adi::Pneumatics descore_mech('B', false); // Pneumatic for the mobile goal lift
     inline pros::Distance front_distance(9);
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <functional>
+
+#include "api.h"
+
+/**
+ * System identification for the drive and mechanisms.
+ *
+ * Runs quasistatic voltage ramps and dynamic steps on a mechanism, logs what it
+ * did and fits output = kS * sgn(v) + kV * v + kA * a by least squares.
+ * Outputs are out of 127 so the constants drop straight into the feedforward
+ * setters in motion.hpp.
+ */
+namespace sysid {
+/**
+ * One logged sample.
+ */
+struct sample {
+  uint32_t time;   // ms
+  int test;        // which test this came from, velocity isn't differenced across tests
+  double output;   // commanded, -127 to 127
+  double voltage;  // V, measured
+  double position;
+  double current;  // mA, measured
+};
+
+/**
+ * Fitted constants.
+ */
+struct result {
+  double kS;
+  double kV;
+  double kA;
+  double r2;  // how much of the output the fit explains, 1 is perfect
+  int samples;
+};
+
+/**
+ * Something to characterize.
+ */
+struct mechanism {
+  const char* name;
+  std::function<void(double)> output_set;  // -127 to 127
+  std::function<double()> position_get;    // velocity and acceleration are found from this
+  std::function<double()> voltage_get;     // V
+  std::function<double()> current_get;     // mA
+  double min_velocity;                     // slower samples are mostly static friction and are ignored
+};
+
+/**
+ * How hard and how long to run each test.
+ */
+struct settings {
+  double ramp_rate = 10.0;    // output per second for quasistatic tests
+  int ramp_time = 4000;       // ms
+  double step_output = 60.0;  // output for dynamic tests
+  int step_time = 1000;       // ms
+  int rest_time = 1000;       // ms between tests so the mechanism comes to a stop
+};
+
+/**
+ * Clears the log.
+ */
+void log_clear();
+
+/**
+ * Returns how many samples are logged.
+ */
+int samples_amount();
+
+/**
+ * Returns a logged sample.
+ *
+ * \param index
+ *        sample to get, starting at 0
+ */
+sample sample_get(int index);
+
+/**
+ * Ramps the output up slowly from 0 and logs every 10ms.
+ *
+ * \param m
+ *        mechanism to run
+ * \param rate
+ *        output per second, negative runs backward
+ * \param time
+ *        how long to ramp in ms
+ */
+void quasistatic(mechanism& m, double rate, int time);
+
+/**
+ * Steps the output from 0 and logs every 10ms.
+ *
+ * \param m
+ *        mechanism to run
+ * \param output
+ *        output to step to, negative runs backward
+ * \param time
+ *        how long to hold it in ms
+ */
+void dynamic(mechanism& m, double output, int time);
+
+/**
+ * Fits kS, kV and kA to samples by least squares.
+ *
+ * \param samples
+ *        logged samples, in the order they were taken
+ * \param amount
+ *        how many samples there are
+ * \param min_velocity
+ *        samples slower than this are ignored
+ */
+result fit(const sample* samples, int amount, double min_velocity);
+
+/**
+ * Writes the log to /usd/sysid_<name>.csv.  Returns false without an SD card.
+ *
+ * \param name
+ *        name of the mechanism
+ */
+bool log_save(const char* name);
+
+/**
+ * Runs quasistatic and dynamic tests both ways, then saves the log and fits it.
+ *
+ * \param m
+ *        mechanism to run
+ * \param s
+ *        how hard and how long to run each test
+ */
+result characterize(mechanism& m, settings s = {});
+
+/**
+ * Prints fitted constants.
+ *
+ * \param name
+ *        name of the mechanism
+ * \param r
+ *        fitted constants
+ */
+void result_print(const char* name, result r);
+}  // namespace sysid
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "EZ-Template/api.hpp"
+
+/**
+ * Mechanism actions that run on their own as a motion progresses.
+ *
+ * Schedule actions before a motion, then start the motion.  Actions are
+ * measured from the start of the next motion and a background task runs each
+ * one as soon as its trigger is met, so mechanisms work while the drive moves.
+ *
+ * The drive helpers in autons.cpp and the motion task mark motion starts
+ * automatically.  Call motion_start() after starting a motion any other way.
+ *
+ * Actions are plain functions so scheduling never allocates, lambdas work as
+ * long as they don't capture anything:
+ *   timeline::at_distance(12_in, []() { intake.move(127); });
+ */
+namespace timeline {
+/**
+ * What an action waits for.
+ */
+enum e_trigger {
+  DISTANCE = 0,    // inches travelled since the motion started, either way
+  PATH_INDEX = 1,  // index of the path point the motion is going to
+  TIME = 2,        // time since the motion started
+  HEADING = 3      // heading reached or passed
+};
+
+/**
+ * Most actions that can be scheduled at once.
+ */
+const int MAX_ACTIONS = 32;
+
+/**
+ * Starts the task that runs actions.  Run this in initialize().
+ */
+void initialize();
+
+/**
+ * Runs an action once the robot has travelled a distance.  Returns false if
+ * too many actions are scheduled.
+ *
+ * \param distance
+ *        distance from the start of the motion
+ * \param action
+ *        function to run
+ */
+bool at_distance(okapi::QLength distance, void (*action)());
+
+/**
+ * Runs an action once the motion reaches a point on its path.  This only works
+ * with paths and trajectories run by the motion task.  Returns false if too
+ * many actions are scheduled.
+ *
+ * \param index
+ *        for paths, index of the input point, 0 is the first point.  For
+ *        trajectories, index of the trajectory sample, which is 10ms apart for
+ *        spline_generate() trajectories
+ * \param action
+ *        function to run
+ */
+bool at_index(int index, void (*action)());
+
+/**
+ * Runs an action a set time into the motion.  Returns false if too many
+ * actions are scheduled.
+ *
+ * \param time
+ *        time from the start of the motion
+ * \param action
+ *        function to run
+ */
+bool at_time(okapi::QTime time, void (*action)());
+
+/**
+ * Runs an action once the robot reaches or passes a heading.  Returns false
+ * if too many actions are scheduled.
+ *
+ * \param heading
+ *        absolute heading
+ * \param action
+ *        function to run
+ */
+bool at_heading(okapi::QAngle heading, void (*action)());
+
+/**
+ * Marks the start of a motion.  Actions scheduled since the last start are
+ * measured from here.
+ */
+void motion_start();
+
+/**
+ * Removes every action that hasn't run.
+ */
+void clear();
+
+/**
+ * Returns how many actions haven't run yet.
+ */
+int pending_amount();
+
+/**
+ * Blocks until every scheduled action has run.
+ *
+ * \param timeout
+ *        longest to wait in ms
+ */
+void wait(int timeout = 5000);
+}  // namespace timeline
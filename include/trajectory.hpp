@@ -0,0 +1,149 @@
+#pragma once
+
+#include <span>
+
+#include "EZ-Template/util.hpp"
+#include "okapi/squiggles/geometry/profilepoint.hpp"
+
+/**
+ * A time parameterized path: where the robot should be and how fast it should
+ * be going at every moment of a motion.
+ *
+ * Points are in inches and degrees with EZ-Template's odom convention (0 faces
+ * +y, positive is clockwise), ordered by time.  A Trajectory only views its
+ * points, so they can live in a TrajectoryBuffer<N>, a static array or flash.
+ */
+class Trajectory {
+ public:
+  /**
+   * One timed sample.
+   */
+  struct point {
+    double time;          // s from the start of the trajectory
+    double x;             // in
+    double y;             // in
+    double theta;         // deg
+    double velocity;      // in/s, negative drives backward
+    double acceleration;  // in/s^2
+    double curvature;     // 1/in, positive curves clockwise
+  };
+
+  /**
+   * Creates a trajectory that builds into storage.
+   *
+   * \param storage
+   *        where points go, this has to outlive the trajectory
+   * \param amount
+   *        how many points in storage are already filled in
+   */
+  Trajectory(std::span<point> storage, int amount = 0);
+
+  /**
+   * Creates a read only trajectory from points that are already made.
+   *
+   * \param points
+   *        points ordered by time, these have to outlive the trajectory
+   */
+  Trajectory(std::span<const point> points);
+
+  /**
+   * Converts a trajectory from okapi's squiggles.  Returns false if the storage
+   * is too small or the trajectory is read only, the trajectory is empty then.
+   *
+   * Squiggles works in meters and radians with yaw counterclockwise from +x,
+   * the points are converted to inches and EZ-Template's headings.
+   *
+   * \param input
+   *        points from squiggles::SplineGenerator::generate()
+   */
+  bool build(std::span<const squiggles::ProfilePoint> input);
+
+  /**
+   * Start of a trajectory file.  The points follow straight after as an array
+   * of point, exactly how they sit in memory, so loading is a single read.
+   */
+  struct file_header {
+    char magic[4];        // "EZTJ"
+    uint16_t version;     // FILE_VERSION
+    uint16_t point_size;  // sizeof(point), catches files made with a different point
+    uint32_t amount;      // points in the file
+    uint32_t reserved;    // 0, keeps the points 8 byte aligned
+  };
+  static const uint16_t FILE_VERSION = 1;
+
+  /**
+   * Reads a trajectory file into the storage, usually from the SD card.
+   * Returns false if there's no SD card, the file doesn't exist, is a
+   * different version or doesn't fit.  The trajectory is empty then.
+   *
+   * \param path
+   *        file to read, like "/usd/skills.traj"
+   */
+  bool load(const char* path);
+
+  /**
+   * Writes the trajectory to a file load() can read.  Returns false if the
+   * file can't be written.
+   *
+   * \param path
+   *        file to write
+   */
+  bool save(const char* path) const;
+
+  /**
+   * Returns the point at a time, interpolated between the points around it.
+   * Times past either end return that end.
+   *
+   * \param time
+   *        seconds from the start
+   */
+  point sample(double time) const;
+
+  /**
+   * Returns the index of the last point at or before a time.
+   *
+   * \param time
+   *        seconds from the start
+   */
+  int index_get(double time) const;
+
+  /**
+   * Returns how long the trajectory takes in seconds.
+   */
+  double duration() const;
+
+  /**
+   * Removes every point.
+   */
+  void clear();
+
+  /**
+   * Returns the amount of points.
+   */
+  int amount() const;
+
+  /**
+   * Returns how many points fit in the storage.
+   */
+  int capacity() const;
+
+  const point& operator[](int index) const;
+
+ protected:
+  std::span<point> storage;
+  std::span<const point> points;
+};
+
+/**
+ * A trajectory with space for N points.
+ */
+template <int N>
+class TrajectoryBuffer : public Trajectory {
+ public:
+  TrajectoryBuffer() : Trajectory(std::span<point>(buffer)) {}
+  TrajectoryBuffer(const TrajectoryBuffer&) = delete;
+  TrajectoryBuffer& operator=(const TrajectoryBuffer&) = delete;
+
+ private:
+  point buffer[N];
+};
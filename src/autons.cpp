@@ -47,11 +47,34 @@ void default_constants() {
   chassis.slew_drive_constants_set(3_in, 70);
   chassis.slew_swing_constants_set(3_in, 80);
 
+  // Profiled drives, feedforward is out of 127 per in/s and in/s^2
+  motion::drive_feedforward_set(1.0, 2.1, 0.26);
+  motion::pid_profiled_drive_constants_set(8.0, 0.0, 20.0);
+  motion::profiled_drive_constraints_set({50.0, 100.0, 0.0});  // in/s, in/s^2, in/s^3 (0 is a trapezoid)
+
+  // Profiled turns and swings, feedforward is out of 127 per deg/s and deg/s^2
+  motion::turn_feedforward_set(8.0, 0.26, 0.03);
+  motion::swing_feedforward_set(8.0, 0.52, 0.06);
+  motion::pid_profiled_turn_constants_set(6.0, 0.05);
+  motion::pid_profiled_swing_constants_set(9.0, 0.08);
+  motion::profiled_turn_constraints_set({360.0, 1500.0, 0.0});  // deg/s, deg/s^2, deg/s^3
+  motion::profiled_swing_constraints_set({250.0, 1000.0, 0.0});
+  motion::profiled_turn_toggle(false);  // true makes turn() and the swing helpers profiled
+
+  // Gain schedules override the constants above by motion size, error or speed, and are off until set
+  // motion::drive_gain_schedule_set(GainSchedule(GainSchedule::DISTANCE, {{4.0, {26.0, 0.0, 80.0}}, {24.0, {20.0, 0.001, 90.0}}, {96.0, {15.0, 0.001, 110.0}}}));
+  // motion::turn_gain_schedule_set(GainSchedule(GainSchedule::DISTANCE, {{45.0, {3.5, 0.05, 20.0, 15.0}}, {270.0, {2.6, 0.05, 24.0, 15.0}}}));
+
   // The amount that turns are prioritized over driving in odom motions
   // - if you have tracking wheels, you can run this higher.  1.0 is the max
   chassis.odom_turn_bias_set(0.9);
 
   chassis.odom_look_ahead_set(7_in);           // This is how far ahead in the path the robot looks at
+  motion::path_smooth_constants_set(0.75, 0.03, 0.0001);  // Smoothing for paths built into a PathBuffer
+  motion::pp_adaptive_constants_set({4.0, 14.0, 0.2, 60.0, 100.0});  // Look ahead min/max in, look ahead s, lateral and braking in/s^2
+  motion::pp_adaptive_toggle(false);                                  // true grows look ahead with speed and slows for corners
+  motion::ramsete_constants_set(2.0, 0.7, 4.0);                       // Trajectory tracking, b and zeta as usually given, then output per in/s
+  motion::spline_constraints_set({55.0, 100.0, 0.0});                 // Spline trajectory limits, in/s, in/s^2, in/s^3 (0 isn't limited)
   chassis.odom_boomerang_distance_set(16_in);  // This sets the maximum distance away from target that the carrot point can be
   chassis.odom_boomerang_dlead_set(0.625);     // This handles how aggressive the end of boomerang motions are
 
@@ -324,6 +347,156 @@ void odom_boomerang_injected_pure_pursuit_example() {
   chassis.pid_wait();
 }
 
+///
+// Motion Queue
+///
+void motion_queue_example() {
+  // Queued motions are prepared while the motion ahead of them runs,
+  // and the motion task starts the next one in the same loop the last one exits
+  motion::queue_drive(24_in, DRIVE_SPEED, true);
+  motion::queue_turn(90_deg, TURN_SPEED);
+  motion::queue_swing(ez::LEFT_SWING, 0_deg, SWING_SPEED, 45);
+  motion::queue_drive(-24_in, DRIVE_SPEED, true);
+
+  // Nothing above blocks, so mechanisms can be run here while the drive works through the queue
+  motion::wait();
+}
+
+///
+// Profiled Motion Example
+///
+void profiled_motion_example() {
+  // Uses the default limits from default_constants()
+  motion::pid_profiled_drive_set(24_in);
+  motion::wait();
+
+  // Limits can be set per motion, giving a jerk makes it an S-curve
+  motion::pid_profiled_drive_set(-24_in, {30.0, 60.0, 300.0});
+  motion::wait();
+
+  // Turns and swings take deg/s, deg/s^2 and deg/s^3
+  motion::pid_profiled_turn_set(90_deg);
+  profiler::motion_wait();
+
+  motion::pid_profiled_swing_set(ez::LEFT_SWING, 0_deg, {180.0, 720.0, 6000.0});
+  profiler::motion_wait();
+}
+
+///
+// Pure Pursuit Without Allocating
+///
+// Paths are built straight into this, so starting one never touches the heap
+PathBuffer<256> example_path;
+
+void odom_pp_buffer_example() {
+  motion::pid_odom_smooth_pp_set(example_path, {{{0, 24}, fwd, DRIVE_SPEED},
+                                                {{12, 24}, fwd, DRIVE_SPEED},
+                                                {{24, 24}, fwd, DRIVE_SPEED}});
+  profiler::motion_wait();
+
+  // The same storage can be reused, the motion holding it is released before it's rebuilt
+  motion::pid_odom_injected_pp_set(example_path, {{{0, 0}, rev, DRIVE_SPEED}});
+  profiler::motion_wait();
+}
+
+///
+// Cached Paths
+///
+void paths_register() {
+  // Cached paths start where the robot will be, so the first point is the robot's pose
+  paths::add(PATH_EXAMPLE_OUT, {{{0, 0}, fwd, DRIVE_SPEED},
+                                {{0, 24}, fwd, DRIVE_SPEED},
+                                {{12, 24}, fwd, DRIVE_SPEED},
+                                {{24, 24}, fwd, DRIVE_SPEED}});
+  paths::add(PATH_EXAMPLE_BACK, {{{24, 24}, rev, DRIVE_SPEED},
+                                 {{0, 0}, rev, DRIVE_SPEED}},
+             false);
+}
+
+void odom_pp_cached_example() {
+  // These were injected and smoothed in initialize(), so they start right away
+  motion::pid_odom_pp_set(PATH_EXAMPLE_OUT);
+  profiler::motion_wait();
+
+  motion::pid_odom_pp_set(PATH_EXAMPLE_BACK);
+  profiler::motion_wait();
+}
+
+///
+// Compiled Paths
+///
+// Injected, smoothed and given curvature by the compiler, the points live in flash
+constexpr ez::odom example_route[] = {{{0, 0}, fwd, DRIVE_SPEED},
+                                      {{0, 24}, fwd, DRIVE_SPEED},
+                                      {{12, 24}, fwd, DRIVE_SPEED},
+                                      {{24, 24}, fwd, DRIVE_SPEED}};
+constexpr auto example_route_points = paths::compile<example_route, 0.5>();
+constexpr Path example_route_path(example_route_points);
+
+void odom_pp_compiled_example() {
+  // The path has to start where the robot is
+  motion::pid_odom_pp_set(example_route_path);
+  profiler::motion_wait();
+}
+
+///
+// Spline Trajectory Example
+///
+// 10ms samples, enough for about 5s of driving
+TrajectoryBuffer<512> example_spline;
+TrajectoryBuffer<512> example_trajectory;
+
+void trajectories_generate() {
+  // Trajectories start where the robot will be, headings are optional and points without one face the next point
+  const ez::united_pose waypoints[] = {{0_in, 24_in, 0_deg},
+                                       {24_in, 48_in, 90_deg},
+                                       {48_in, 48_in}};
+  if (!motion::spline_generate(example_spline, {0, 0, 0}, waypoints))
+    printf("Couldn't generate example_spline\n");
+}
+
+void odom_spline_example() {
+  // Generated in initialize(), squiggles is too slow to run during the match
+  motion::pid_odom_trajectory_set(example_spline);
+  profiler::motion_wait();
+}
+
+// Made on a computer with tools/trajectory_gen.cpp and copied to the SD card
+void odom_trajectory_file_example() {
+  if (!example_trajectory.load("/usd/example.traj")) {
+    printf("Couldn't load /usd/example.traj\n");
+    return;
+  }
+  motion::pid_odom_trajectory_set(example_trajectory);
+  profiler::motion_wait();
+}
+
+///
+// Action Timeline Example
+///
+void timeline_example() {
+  // Actions are scheduled before the motion and run while it drives, instead of after it
+  timeline::at_time(0_ms, []() { intake.move(127); });
+  timeline::at_distance(12_in, []() { block_collector.set_value(true); });
+  timeline::at_distance(20_in, []() { combine.move(-127); });
+  chassis.pid_drive_set(24_in, DRIVE_SPEED, true);
+  timeline::motion_start();
+  profiler::wait();
+
+  // Heading triggers fire once the robot reaches or passes the heading
+  timeline::at_heading(45_deg, []() { hood.move(-127); });
+  timeline::at_time(600_ms, []() { block_collector.set_value(false); });
+  chassis.pid_turn_set(90_deg, TURN_SPEED);
+  timeline::motion_start();
+  profiler::wait();
+
+  // Anything still scheduled gets to finish before moving on
+  timeline::wait();
+  intake.move(0);
+  combine.move(0);
+  hood.move(0);
+}
+
 ///
 // Calculate the offsets of your tracking wheels
 ///
@@ -384,36 +557,189 @@ void measure_offsets() {
   if (chassis.odom_tracker_front != nullptr) chassis.odom_tracker_front->distance_to_center_set(f_offset);
 }
 
+///
+// Characterize the drive and mechanisms
+///
+sysid::mechanism motorMechanism(const char* name, pros::Motor& motor) {
+  // Raw output, a battery::CompensatedMotor would scale it and the fit would be off by the scale
+  return {name,
+          [&motor](double output) { motor.pros::Motor::move(output); },
+          [&motor]() { return motor.get_position(); },
+          [&motor]() { return motor.get_voltage() / 1000.0; },
+          [&motor]() { return (double)motor.get_current_draw(); },
+          10.0};
+}
+
+void characterize() {
+  // The drive needs about 4 feet clear in front and behind, and room to spin
+  motion::stop();
+  chassis.drive_mode_set(ez::DISABLE);
+  chassis.drive_brake_set(MOTOR_BRAKE_COAST);
+  printf("\n---- Characterization ----\n");
+
+  // Linear, both sides driven together and measured in inches
+  sysid::mechanism drive = {
+      "drive",
+      [](double output) { chassis.drive_set(output, output); },
+      []() { return (chassis.drive_sensor_left() + chassis.drive_sensor_right()) / 2.0; },
+      []() { return chassis.left_motors[0].get_voltage() / 1000.0; },
+      []() { return (double)chassis.left_motors[0].get_current_draw(); },
+      1.0};
+  sysid::result linear = sysid::characterize(drive);
+
+  // Angular, spinning in place and measured in degrees with the IMU
+  sysid::mechanism spin = {
+      "angular",
+      [](double output) { chassis.drive_set(output, -output); },
+      []() { return chassis.drive_imu_get(); },
+      []() { return chassis.left_motors[0].get_voltage() / 1000.0; },
+      []() { return (double)chassis.left_motors[0].get_current_draw(); },
+      5.0};
+  sysid::result angular = sysid::characterize(spin, {5.0, 4000, 40.0, 1000, 1000});
+
+  // Mechanisms are in motor degrees
+  sysid::mechanism mechanisms[] = {motorMechanism("intake", intake), motorMechanism("combine", combine), motorMechanism("hood", hood)};
+  for (auto& m : mechanisms) sysid::characterize(m);
+
+  printf("Paste into default_constants():\n");
+  printf("  motion::drive_feedforward_set(%.3f, %.4f, %.4f);\n", linear.kS, linear.kV, linear.kA);
+  printf("  motion::turn_feedforward_set(%.3f, %.4f, %.4f);\n", angular.kS, angular.kV, angular.kA);
+}
+
 
 // Custom Helper Functions
-void drive(QLength distance, int speed = DRIVE_SPEED, bool slew = true) {
+
+// EZ-Template can't look constants up while it runs, so schedules set the chassis constants when a motion starts.
+// The tuned constants are saved first and scheduleRestore() puts them back once the motion is done, so motions
+// that don't go through these helpers still run on default_constants()
+static ez::e_mode scheduled = ez::DISABLE;
+static ez::PID::Constants savedForward, savedBackward;
+
+void driveScheduleApply(double distance, int speed) {
+  const GainSchedule& schedule = motion::drive_gain_schedule_get();
+  if (!schedule.enabled()) return;
+  savedForward = chassis.pid_drive_constants_forward_get();
+  savedBackward = chassis.pid_drive_constants_backward_get();
+  scheduled = ez::DRIVE;
+  ez::PID::Constants c = schedule.motion_get(distance, speed);
+  chassis.pid_drive_constants_set(c.kp, c.ki, c.kd, c.start_i);
+}
+
+void turnScheduleApply(double target, int speed) {
+  const GainSchedule& schedule = motion::turn_gain_schedule_get();
+  if (!schedule.enabled()) return;
+  double current = chassis.drive_imu_get();
+  double distance = motion::angle_target_get(target, current, chassis.pid_turn_behavior_get()) - current;
+  savedForward = chassis.pid_turn_constants_get();
+  scheduled = ez::TURN;
+  ez::PID::Constants c = schedule.motion_get(distance, speed);
+  chassis.pid_turn_constants_set(c.kp, c.ki, c.kd, c.start_i);
+}
+
+void swingScheduleApply(double target, int speed) {
+  const GainSchedule& schedule = motion::swing_gain_schedule_get();
+  if (!schedule.enabled()) return;
+  double current = chassis.drive_imu_get();
+  double distance = motion::angle_target_get(target, current, chassis.pid_swing_behavior_get()) - current;
+  savedForward = chassis.pid_swing_constants_forward_get();
+  savedBackward = chassis.pid_swing_constants_backward_get();
+  scheduled = ez::SWING;
+  ez::PID::Constants c = schedule.motion_get(distance, speed);
+  chassis.pid_swing_constants_set(c.kp, c.ki, c.kd, c.start_i);
+}
+
+void scheduleRestore() {
+  ez::PID::Constants f = savedForward, b = savedBackward;
+  switch (scheduled) {
+    case ez::DRIVE:
+      chassis.pid_drive_constants_forward_set(f.kp, f.ki, f.kd, f.start_i);
+      chassis.pid_drive_constants_backward_set(b.kp, b.ki, b.kd, b.start_i);
+      break;
+    case ez::TURN:
+      chassis.pid_turn_constants_set(f.kp, f.ki, f.kd, f.start_i);
+      break;
+    case ez::SWING:
+      chassis.pid_swing_constants_forward_set(f.kp, f.ki, f.kd, f.start_i);
+      chassis.pid_swing_constants_backward_set(b.kp, b.ki, b.kd, b.start_i);
+      break;
+    default:
+      break;
+  }
+  scheduled = ez::DISABLE;
+}
+
+void drive(QLength distance, int speed = DRIVE_SPEED, bool slew = true, std::source_location loc = std::source_location::current()) {
+  driveScheduleApply(distance.convert(inch), speed);
   chassis.pid_drive_set(distance, speed, slew);
-  chassis.pid_wait();
+  timeline::motion_start();
+  profiler::wait(loc);
+  scheduleRestore();
 }
 
-void turn(okapi::QAngle angle, int speed = TURN_SPEED) {
+// Profiled turns scale their velocity limit by speed out of 127
+MotionProfile::constraints speedScaled(MotionProfile::constraints limits, int speed) {
+  limits.velocity *= abs(speed) / 127.0;
+  return limits;
+}
+
+void turn(okapi::QAngle angle, int speed = TURN_SPEED, std::source_location loc = std::source_location::current()) {
+  if (motion::profiled_turn_enabled()) {
+    motion::pid_profiled_turn_set(angle, speedScaled(motion::profiled_turn_constraints_get(), speed));
+    profiler::motion_wait(loc);
+    return;
+  }
+  turnScheduleApply(angle.convert(degree), speed);
   chassis.pid_turn_set(angle, speed);
-  chassis.pid_wait();
+  timeline::motion_start();
+  profiler::wait(loc);
+  scheduleRestore();
 }
 
-void swingAbsLeft(double deg, int speed = 90) {
+void turnProfiled(okapi::QAngle angle, int speed = TURN_SPEED, std::source_location loc = std::source_location::current()) {
+  motion::pid_profiled_turn_set(angle, speedScaled(motion::profiled_turn_constraints_get(), speed));
+  profiler::motion_wait(loc);
+}
+
+void swingAbsLeft(double deg, int speed = 90, std::source_location loc = std::source_location::current()) {
+  if (motion::profiled_turn_enabled()) {
+    motion::pid_profiled_swing_set(ez::LEFT_SWING, deg * 1_deg, speedScaled(motion::profiled_swing_constraints_get(), speed));
+    profiler::motion_wait(loc);
+    return;
+  }
+  swingScheduleApply(deg, speed);
   chassis.pid_swing_set(ez::LEFT_SWING, deg * 1_deg, speed);
-  chassis.pid_wait();
+  timeline::motion_start();
+  profiler::wait(loc);
+  scheduleRestore();
 }
 
-void swingAbsRight(double deg, int speed = 90) {
+void swingAbsRight(double deg, int speed = 90, std::source_location loc = std::source_location::current()) {
+  if (motion::profiled_turn_enabled()) {
+    motion::pid_profiled_swing_set(ez::RIGHT_SWING, deg * 1_deg, speedScaled(motion::profiled_swing_constraints_get(), speed));
+    profiler::motion_wait(loc);
+    return;
+  }
+  swingScheduleApply(deg, speed);
   chassis.pid_swing_set(ez::RIGHT_SWING, deg * 1_deg, speed);
-  chassis.pid_wait();
+  timeline::motion_start();
+  profiler::wait(loc);
+  scheduleRestore();
 }
 
-void arcRightAbs(double deg, int turnSpeed = 90, int insideSpeed = 30) {
+void arcRightAbs(double deg, int turnSpeed = 90, int insideSpeed = 30, std::source_location loc = std::source_location::current()) {
+  swingScheduleApply(deg, turnSpeed);
   chassis.pid_swing_set(ez::RIGHT_SWING, deg * 1_deg, turnSpeed, insideSpeed);
-  chassis.pid_wait();
+  timeline::motion_start();
+  profiler::wait(loc);
+  scheduleRestore();
 }
 
-void arcLeftAbs(double deg, int turnSpeed = 90, int insideSpeed = 30) {
+void arcLeftAbs(double deg, int turnSpeed = 90, int insideSpeed = 30, std::source_location loc = std::source_location::current()) {
+  swingScheduleApply(deg, turnSpeed);
   chassis.pid_swing_set(ez::LEFT_SWING, deg * 1_deg, turnSpeed, insideSpeed);
-  chassis.pid_wait();
+  timeline::motion_start();
+  profiler::wait(loc);
+  scheduleRestore();
 }
 
 
@@ -0,0 +1,65 @@
+#include "battery.hpp"
+
+#include "EZ-Template/util.hpp"
+
+namespace battery {
+// Below this the reading is bad, the brain is on USB power or the battery is unplugged
+static const double MIN_VALID_VOLTAGE = 6.0;
+static const double MAX_SCALE = 1.3;
+static const double FILTER_GAIN = 0.2;
+
+static double nominal = 12.0;
+static bool enabled = false;
+
+// Single word floats so reads never tear and don't need the lock.  filtered is only written by the battery task,
+// but scale is also written by the setters on the caller's task
+static volatile float filtered = 0.0f;
+static volatile float scale = 1.0f;
+
+// Held for every scale update, so the task can't write a scale worked out from the old settings over a new one
+static pros::Mutex lock;
+
+static void scale_update() {
+  lock.take();
+  if (!enabled || filtered < MIN_VALID_VOLTAGE)
+    scale = 1.0f;
+  else
+    scale = std::clamp(nominal / filtered, 1.0 / MAX_SCALE, MAX_SCALE);
+  lock.give();
+}
+
+static void battery_task(int period) {
+  uint32_t now = pros::millis();
+  while (true) {
+    double reading = pros::battery::get_voltage() / 1000.0;
+    if (filtered < MIN_VALID_VOLTAGE)
+      filtered = reading;
+    else
+      filtered = filtered + FILTER_GAIN * (reading - filtered);
+    scale_update();
+    pros::Task::delay_until(&now, period);
+  }
+}
+
+void initialize(int period) {
+  pros::Task task([period]() { battery_task(period); }, TASK_PRIORITY_MIN + 1, TASK_STACK_DEPTH_MIN, "Battery");
+}
+
+void nominal_set(double volts) {
+  nominal = volts;
+  scale_update();
+}
+double nominal_get() { return nominal; }
+
+void compensation_toggle(bool toggle) {
+  enabled = toggle;
+  scale_update();
+}
+bool compensation_enabled() { return enabled; }
+
+double voltage_get() { return filtered; }
+
+double scale_get() { return scale; }
+
+double compensate(double output) { return ez::util::clamp(output * scale, 127); }
+}  // namespace battery
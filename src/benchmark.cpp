@@ -0,0 +1,211 @@
+#include "benchmark.hpp"
+
+#include <atomic>
+#include <new>
+
+#include "path.hpp"
+#include "subsystems.hpp"
+
+///
+// Allocation counting
+///
+// This replaces operator new for the whole program, so it's only built in with BENCH_ALLOCATIONS:=1
+#if BENCH_ALLOCATIONS
+static std::atomic<uint32_t> allocations{0};
+
+static void* counted_alloc(size_t size, size_t alignment) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  if (size == 0) size = 1;
+  if (alignment <= alignof(std::max_align_t)) return malloc(size);
+  return aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);  // Size has to be a multiple of the alignment
+}
+
+static void* counted_new(size_t size, size_t alignment) {
+  void* p = counted_alloc(size, alignment);
+  if (p == nullptr) throw std::bad_alloc();
+  return p;
+}
+
+void* operator new(size_t size) { return counted_new(size, 0); }
+void* operator new[](size_t size) { return counted_new(size, 0); }
+void* operator new(size_t size, std::align_val_t al) { return counted_new(size, (size_t)al); }
+void* operator new[](size_t size, std::align_val_t al) { return counted_new(size, (size_t)al); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return counted_alloc(size, 0); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return counted_alloc(size, 0); }
+void* operator new(size_t size, std::align_val_t al, const std::nothrow_t&) noexcept { return counted_alloc(size, (size_t)al); }
+void* operator new[](size_t size, std::align_val_t al, const std::nothrow_t&) noexcept { return counted_alloc(size, (size_t)al); }
+
+// malloc and aligned_alloc both hand back memory free() takes
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete[](void* p, size_t) noexcept { free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { free(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { free(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { free(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { free(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { free(p); }
+#endif
+
+namespace bench {
+#if BENCH_ALLOCATIONS
+uint32_t allocations_get() { return allocations.load(std::memory_order_relaxed); }
+#else
+uint32_t allocations_get() { return 0; }
+#endif
+
+static volatile double sink = 0.0;
+void keep(double value) { sink = value; }
+
+void result_print(result r) {
+  if (BENCH_ALLOCATIONS)
+    printf("%-32s %9i %12.1f ns/op %8.3f allocs/op\n", r.name, r.iterations, r.ns_per_op, r.allocs_per_op);
+  else
+    printf("%-32s %9i %12.1f ns/op\n", r.name, r.iterations, r.ns_per_op);
+}
+
+///
+// Private members
+///
+// inject_points, smooth_path and the solve_xy functions are private to Drive.  Explicit instantiations
+// can name private members, so this hands their pointers out through a friend function to time them directly.
+template <typename Tag, typename Tag::type M>
+struct expose {
+  friend typename Tag::type member(Tag) { return M; }
+};
+
+struct inject_points_tag {
+  using type = std::vector<ez::odom> (ez::Drive::*)(std::vector<ez::odom>);
+  friend type member(inject_points_tag);
+};
+struct smooth_path_tag {
+  using type = std::vector<ez::odom> (ez::Drive::*)(std::vector<ez::odom>, double, double, double);
+  friend type member(smooth_path_tag);
+};
+struct solve_xy_vert_tag {
+  using type = ez::pose (ez::Drive::*)(float, float, float, float);
+  friend type member(solve_xy_vert_tag);
+};
+struct solve_xy_horiz_tag {
+  using type = ez::pose (ez::Drive::*)(float, float, float, float);
+  friend type member(solve_xy_horiz_tag);
+};
+
+template struct expose<inject_points_tag, &ez::Drive::inject_points>;
+template struct expose<smooth_path_tag, &ez::Drive::smooth_path>;
+template struct expose<solve_xy_vert_tag, &ez::Drive::solve_xy_vert>;
+template struct expose<solve_xy_horiz_tag, &ez::Drive::solve_xy_horiz>;
+
+///
+// Kernels
+///
+static void pid_benchmarks() {
+  ez::PID pid(20.0, 0.001, 90.0, 0.0);
+  pid.target_set(24.0);
+  run("PID::compute", 100000, [&](int i) {
+    keep(pid.compute((i % 2400) / 100.0));
+  });
+
+  pid.exit_condition_set(90, 1, 250, 3, 500, 500);
+  run("PID::exit_condition", 100000, [&](int i) {
+    pid.error = 24.0 - (i % 2400) / 100.0;
+    keep(pid.exit_condition());
+    if (i % 1000 == 0) pid.timers_reset();
+  });
+}
+
+static void slew_benchmarks() {
+  ez::slew slew(3.0, 70);
+  slew.initialize(true, 127, 24.0, 0.0);
+  run("slew::iterate", 100000, [&](int i) {
+    keep(slew.iterate((i % 2400) / 100.0));
+  });
+}
+
+static void util_benchmarks() {
+  run("util::turn_shortest", 100000, [](int i) {
+    keep(ez::util::turn_shortest(i % 720 - 360, (i * 7) % 360));
+  });
+  run("util::turn_longest", 100000, [](int i) {
+    keep(ez::util::turn_longest(i % 720 - 360, (i * 7) % 360));
+  });
+  run("Drive::opcontrol_curve_left", 100000, [](int i) {
+    keep(chassis.opcontrol_curve_left(i % 255 - 127));
+  });
+}
+
+// One 10ms odom step each, with deltas a robot at full speed sees
+static void odom_benchmarks() {
+  auto solve_xy_vert = member(solve_xy_vert_tag{});
+  auto solve_xy_horiz = member(solve_xy_horiz_tag{});
+  run("Drive::solve_xy_vert", 100000, [&](int i) {
+    keep((chassis.*solve_xy_vert)(1.5, ez::util::to_rad(i % 360), 0.6, ez::util::to_rad((i % 7) * 0.5 - 1.5)).x);
+  });
+  run("Drive::solve_xy_horiz", 100000, [&](int i) {
+    keep((chassis.*solve_xy_horiz)(-2.0, ez::util::to_rad(i % 360), 0.1, ez::util::to_rad((i % 7) * 0.5 - 1.5)).y);
+  });
+}
+
+static void path_benchmarks() {
+  std::vector<ez::odom> path = {{{0, 24}, ez::fwd, 110},
+                                {{24, 48}, ez::fwd, 110},
+                                {{48, 48}, ez::fwd, 110},
+                                {{72, 24}, ez::fwd, 110},
+                                {{72, -24}, ez::fwd, 110}};
+
+  bool drive_toggle = chassis.pid_drive_toggle_get();
+  bool print_toggle = chassis.pid_print_toggle_get();
+  chassis.pid_drive_toggle(false);
+  chassis.pid_print_toggle(false);
+
+  // Each step on its own, then through the public setters that run them
+  auto inject_points = member(inject_points_tag{});
+  auto smooth_path = member(smooth_path_tag{});
+  std::vector<ez::odom> injected = (chassis.*inject_points)(path);
+  std::vector<double> smooth = chassis.odom_path_smooth_constants_get();
+  run("Drive::inject_points", 50, [&](int) {
+    keep((chassis.*inject_points)(path).size());
+  });
+  run("Drive::smooth_path", 50, [&](int) {
+    keep((chassis.*smooth_path)(injected, smooth[0], smooth[1], smooth[2]).size());
+  });
+  run("pid_odom_injected_pp_set", 50, [&](int) {
+    chassis.pid_odom_injected_pp_set(path, false);
+  });
+  run("pid_odom_smooth_pp_set", 50, [&](int) {
+    chassis.pid_odom_smooth_pp_set(path, false);
+  });
+
+  // The same processing into caller owned storage
+  static PathBuffer<512> buffer;
+  double spacing = chassis.odom_path_spacing_get();
+  run("Path::build", 50, [&](int) {
+    buffer.build(chassis.odom_pose_get(), path, spacing);
+  });
+  run("Path::build + smooth", 50, [&](int) {
+    buffer.build(chassis.odom_pose_get(), path, spacing);
+    buffer.smooth();
+  });
+  run("Path::build_spline", 50, [&](int) {
+    buffer.build_spline(chassis.odom_pose_get(), path, spacing);
+  });
+
+  chassis.drive_mode_set(ez::DISABLE);
+  chassis.pid_drive_toggle(drive_toggle);
+  chassis.pid_print_toggle(print_toggle);
+}
+
+void auton() {
+  ez::screen_print("Running benchmarks...", 1);
+  printf("\n---- Benchmarks ----\n");
+  pid_benchmarks();
+  slew_benchmarks();
+  util_benchmarks();
+  odom_benchmarks();
+  path_benchmarks();
+  ez::screen_print("Benchmarks done, results are in the terminal", 1);
+}
+}  // namespace bench
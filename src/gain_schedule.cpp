@@ -0,0 +1,69 @@
+#include "gain_schedule.hpp"
+
+#include <cmath>
+
+GainSchedule::GainSchedule() {}
+
+GainSchedule::GainSchedule(e_key key, std::initializer_list<point> points) : key(key) {
+  for (const point& p : points) point_add(p.at, p.constants);
+}
+
+static ez::PID::Constants lerp(ez::PID::Constants a, ez::PID::Constants b, double t) {
+  return {a.kp + (b.kp - a.kp) * t,
+          a.ki + (b.ki - a.ki) * t,
+          a.kd + (b.kd - a.kd) * t,
+          a.start_i + (b.start_i - a.start_i) * t};
+}
+
+bool GainSchedule::point_add(double at, ez::PID::Constants constants) {
+  if (amount >= MAX_POINTS) return false;
+
+  // Keep points sorted so interpolating is a single walk
+  at = fabs(at);
+  int i = amount;
+  while (i > 0 && points[i - 1].at > at) {
+    points[i] = points[i - 1];
+    i--;
+  }
+  points[i] = {at, constants};
+  amount++;
+  grid_build();
+  return true;
+}
+
+void GainSchedule::clear() { amount = 0; }
+
+bool GainSchedule::enabled() const { return amount > 0; }
+
+GainSchedule::e_key GainSchedule::key_get() const { return key; }
+
+// Exact piecewise linear lookup through the points, only used to build the grid
+ez::PID::Constants GainSchedule::interpolate(double at) const {
+  if (at <= points[0].at) return points[0].constants;
+  for (int i = 1; i < amount; i++) {
+    if (at <= points[i].at)
+      return lerp(points[i - 1].constants, points[i].constants, (at - points[i - 1].at) / (points[i].at - points[i - 1].at));
+  }
+  return points[amount - 1].constants;
+}
+
+void GainSchedule::grid_build() {
+  grid_start = points[0].at;
+  double span = points[amount - 1].at - grid_start;
+  grid_scale = span > 0.0 ? GRID_SIZE / span : 0.0;
+  for (int i = 0; i <= GRID_SIZE; i++)
+    grid[i] = interpolate(grid_start + (grid_scale > 0.0 ? i / grid_scale : 0.0));
+}
+
+ez::PID::Constants GainSchedule::get(double at) const {
+  if (amount == 0) return {0.0, 0.0, 0.0, 0.0};
+  double cell = (fabs(at) - grid_start) * grid_scale;
+  if (cell <= 0.0) return grid[0];
+  if (cell >= GRID_SIZE) return grid[GRID_SIZE];
+  int i = (int)cell;
+  return lerp(grid[i], grid[i + 1], cell - i);
+}
+
+ez::PID::Constants GainSchedule::motion_get(double distance, double speed) const {
+  return get(key == SPEED ? speed : distance);
+}
@@ -0,0 +1,128 @@
+#include "loop_stats.hpp"
+
+#include "EZ-Template/util.hpp"
+
+// Loops register themselves here when they're constructed
+static const int MAX_LOOPS = 8;
+static LoopStats* loops[MAX_LOOPS];
+static int loops_amount = 0;
+
+///
+// Histograms
+///
+void LoopStats::histogram::reset() {
+  memset(counts, 0, sizeof(counts));
+  min = UINT32_MAX;
+  max = 0;
+  total = 0;
+}
+
+void LoopStats::histogram::add(uint32_t us) {
+  int bucket = us / BUCKET_WIDTH;
+  counts[bucket < BUCKETS ? bucket : BUCKETS - 1]++;
+  min = std::min(min, us);
+  max = std::max(max, us);
+  total++;
+}
+
+LoopStats::summary LoopStats::histogram::get() {
+  if (total == 0) return {0, 0, 0, 0};
+
+  // Walk the buckets until half and then 99% of the samples are passed
+  uint32_t p50 = 0, p99 = 0, seen = 0;
+  bool found_p50 = false;
+  for (int i = 0; i < BUCKETS; i++) {
+    seen += counts[i];
+    if (!found_p50 && seen * 2 >= total) {
+      p50 = i * BUCKET_WIDTH;
+      found_p50 = true;
+    }
+    if (seen * 100 >= total * 99) {
+      p99 = i * BUCKET_WIDTH;
+      break;
+    }
+  }
+  // The last bucket holds everything too big to fit, the max is more useful there
+  return {min, std::clamp(p50, min, max), std::clamp(p99, min, max), max};
+}
+
+///
+// Loops
+///
+LoopStats::LoopStats(const char* name, int period) : name(name), nominal(period) {
+  reset();
+  if (loops_amount < MAX_LOOPS) loops[loops_amount++] = this;
+}
+
+void LoopStats::reset() {
+  periods.reset();
+  executions.reset();
+  overruns = 0;
+  last_start = 0;
+}
+
+void LoopStats::iteration_start() {
+  current_start = pros::micros();
+  if (last_start != 0) {
+    uint32_t period = current_start - last_start;
+    periods.add(period);
+    if (period > (uint32_t)(nominal + 1) * 1000) overruns++;
+  }
+  last_start = current_start;
+}
+
+void LoopStats::iteration_end() { executions.add(pros::micros() - current_start); }
+
+void LoopStats::period_nominal_set(int period) { nominal = period; }
+int LoopStats::period_nominal_get() { return nominal; }
+LoopStats::summary LoopStats::period_get() { return periods.get(); }
+LoopStats::summary LoopStats::execution_get() { return executions.get(); }
+uint32_t LoopStats::overruns_get() { return overruns; }
+uint32_t LoopStats::iterations_get() { return periods.total; }
+
+std::string LoopStats::to_string() {
+  summary p = period_get();
+  summary e = execution_get();
+  char out[128];
+  snprintf(out, sizeof(out), "%-8s per %.1f/%.1f/%.1f/%.1f exe %.1f/%.1f/%.1f/%.1f ovr %u",
+           name, p.min / 1000.0, p.p50 / 1000.0, p.p99 / 1000.0, p.max / 1000.0,
+           e.min / 1000.0, e.p50 / 1000.0, e.p99 / 1000.0, e.max / 1000.0, (unsigned)overruns);
+  return out;
+}
+
+void LoopStats::all_print() {
+  printf("\n---- Loop Stats (ms, min/p50/p99/max) ----\n");
+  for (int i = 0; i < loops_amount; i++)
+    printf("%s  (%u iterations, %ims nominal)\n", loops[i]->to_string().c_str(),
+           (unsigned)loops[i]->iterations_get(), loops[i]->period_nominal_get());
+}
+
+void LoopStats::all_screen_print(int line) {
+  std::string out = "";
+  for (int i = 0; i < loops_amount; i++)
+    out += loops[i]->to_string() + "\n";
+  ez::screen_print(out, line);
+}
+
+void LoopStats::all_reset() {
+  for (int i = 0; i < loops_amount; i++)
+    loops[i]->reset();
+}
+
+///
+// Scheduler probe
+///
+static LoopStats probe_stats("probe", 10);
+
+void LoopStats::probe_start(int period, uint32_t priority) {
+  probe_stats.period_nominal_set(period);
+  pros::Task probe([period]() {
+    uint32_t now = pros::millis();
+    while (true) {
+      probe_stats.iteration_start();
+      probe_stats.iteration_end();
+      pros::Task::delay_until(&now, period);
+    }
+  },
+                   priority, TASK_STACK_DEPTH_DEFAULT, "Loop Probe");
+}
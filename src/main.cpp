@@ -28,6 +28,8 @@ ez::Drive chassis(
 // - `4.0` is the distance from the center of the wheel to the center of the robot
 // ez::tracking_wheel horiz_tracker(8, 2.75, 4.0);  // This tracking wheel is perpendicular to the drive wheels
 // ez::tracking_wheel vert_tracker(9, 2.75, 4.0);   // This tracking wheel is parallel to the drive wheels
+// Rotation sensors report every 10ms by default, match them to odometry::rate_set() in initialize()
+// pros::Rotation(8).set_data_rate(5);
 
 /**
  * Runs initialization code. This occurs as soon as the program is started.
@@ -59,6 +61,11 @@ void initialize() {
   // Set the drive to your own constants from autons.cpp!
   default_constants();
 
+  // Inject and smooth cached paths now instead of during the match
+  paths_register();
+  paths::build();
+  trajectories_generate();  // And generate spline trajectories
+
   // These are already defaulted to these buttons, but you can change the left/right curve buttons here!
   // chassis.opcontrol_curve_buttons_left_set(pros::E_CONTROLLER_DIGITAL_LEFT, pros::E_CONTROLLER_DIGITAL_RIGHT);  // If using tank, only the left side is used.
   // chassis.opcontrol_curve_buttons_right_set(pros::E_CONTROLLER_DIGITAL_Y, pros::E_CONTROLLER_DIGITAL_A);
@@ -68,6 +75,17 @@ void initialize() {
   // Initialize chassis and auton selector
   chassis.initialize();
   ez::as::initialize();
+  LoopStats::probe_start();  // Measures scheduling delay at the priority the drive tasks run at
+
+  battery::initialize();
+  battery::compensation_toggle(false);  // true scales drive and mechanism outputs up as the battery sags
+
+  // Motions started through motion:: run in their own task at this rate
+  motion::rate_set(200);
+  motion::initialize();
+  odometry::rate_set(200);  // Pose tracking for motion:: motions, in its own task above everything else
+  odometry::initialize();
+  timeline::initialize();  // Runs mechanism actions scheduled against motions
   master.rumble(chassis.drive_imu_calibrated() ? "." : "---");
 
   ez::as::auton_selector.autons_add({
@@ -78,6 +96,8 @@ void initialize() {
     Auton("Match Auto AWP", MatchAutonAWP),
     Auton("Match Auto Right", MatchAutonR),
     Auton("Match Auto Left", MatchAutonL),
+    Auton("Benchmark", bench::auton),
+    Auton("Characterize", characterize),
 
   });
 
@@ -102,6 +122,7 @@ void disabled() {
  */
 void competition_initialize() {
  ez::as::auton_selector.selected_auton_print();
+  paths::build();  // Builds anything registered since initialize()
 }
 /**
  * Runs the user autonomous code. This function will be started in its own task
@@ -118,8 +139,11 @@ void autonomous() {
   chassis.pid_targets_reset();                // Resets PID targets to 0
   chassis.drive_imu_reset();                  // Reset gyro position to 0
   chassis.drive_sensor_reset();               // Reset drive sensors to 0
-  chassis.odom_xyt_set(0_in, 0_in, 0_deg);    // Set the current position, you can start at a specific position with this
+  odometry::pose_set({0, 0, 0});              // Set the current position here and in EZ-Template, you can start at a specific position with this
   chassis.drive_brake_set(MOTOR_BRAKE_COAST);  // Set motors to hold.  This helps autonomous consistency
+  profiler::reset();                           // Start timing every motion in this auton
+  LoopStats::all_reset();                      // Only measure loop timing during this auton
+  timeline::clear();                           // Drop actions left over from a previous run
 
   /*
   Odometry and Pure Pursuit are not magic
@@ -135,6 +159,8 @@ void autonomous() {
   */
   // MatchAutonR();
   ez::as::auton_selector.selected_auton_call();// Calls selected auton from autonomous selector
+  profiler::report_print();                    // Print where the auton's time went
+  LoopStats::all_print();                      // Print how well every loop kept its rate
 }
 
 /**
@@ -155,8 +181,11 @@ void screen_print_tracker(ez::tracking_wheel *tracker, std::string name, int lin
  * Adding new pages here will let you view them during user control or autonomous
  * and will help you debug problems you're having
  */
+LoopStats screen_stats("screen", ez::util::DELAY_TIME);
 void ez_screen_task() {
   while (true) {
+    screen_stats.iteration_start();
+
     // Only run this when not connected to a competition switch
     if (!pros::competition::is_connected()) {
       // Blank page for odom debugging
@@ -176,6 +205,12 @@ void ez_screen_task() {
           screen_print_tracker(chassis.odom_tracker_front, "f", 7);
         }
       }
+
+      // Blank page for loop timing, period and execution time in ms
+      if (ez::as::page_blank_is_on(1)) {
+        ez::screen_print("loop   min/p50/p99/max", 1);
+        LoopStats::all_screen_print(2);
+      }
     }
 
     // Remove all blank pages when connected to a comp switch
@@ -184,6 +219,7 @@ void ez_screen_task() {
         ez::as::page_blank_remove_all();
     }
 
+    screen_stats.iteration_end();
     pros::delay(ez::util::DELAY_TIME);
   }
 }
@@ -213,6 +249,7 @@ void ez_template_extras() {
     if (master.get_digital(DIGITAL_A) && master.get_digital(DIGITAL_LEFT)) {
       pros::motor_brake_mode_e_t preference = chassis.drive_brake_get();
       autonomous();
+      motion::stop();
       chassis.drive_brake_set(preference);
     }
 
@@ -261,8 +298,12 @@ void opcontrol() {
 
   // This is preference to what you like to drive on
   chassis.drive_brake_set(MOTOR_BRAKE_COAST);
+  motion::stop();  // Don't let an auton motion fight the driver
 
+  static LoopStats opcontrol_stats("opctrl", ez::util::DELAY_TIME);
   while (true) {
+    opcontrol_stats.iteration_start();
+
     // Gives you some extras to make EZ-Template ezier
     ez_template_extras();
 
@@ -361,6 +402,7 @@ bool b_button = master.get_digital(DIGITAL_B);
       latch2 = false; 
     }
    
+    opcontrol_stats.iteration_end();
     pros::delay(ez::util::DELAY_TIME);  // This is used for timer calculations!  Keep this ez::util::DELAY_TIME
   }
     }
@@ -0,0 +1,427 @@
+#include "motion.hpp"
+
+#include "subsystems.hpp"
+#include "timeline.hpp"
+
+namespace motion {
+LoopStats stats("motion", ez::util::DELAY_TIME);
+
+static pros::Mutex lock;
+static Controller* active = nullptr;
+static bool started = false;
+static ez::exit_output exit_state = ez::RUNNING;
+static int period = ez::util::DELAY_TIME;
+static pros::task_t waiter = nullptr;
+
+// Motions waiting behind the active one, in a ring
+static Controller* queued[QUEUE_SIZE];
+static int queue_first = 0;
+static int queue_amount = 0;
+
+// Where the last queued motion is expected to leave the robot facing
+static double queue_heading = 0.0;
+
+static GainSchedule drive_schedule, turn_schedule, swing_schedule;
+
+///
+// Rate
+///
+void rate_set(int hz) {
+  period = std::clamp(1000 / std::clamp(hz, 1, 1000), 1, 1000);
+  stats.period_nominal_set(period);
+}
+int rate_get() { return 1000 / period; }
+int period_get() { return period; }
+
+///
+// Task
+///
+// Wakes up whatever is blocked in wait(), the notification value is the exit type
+static void waiter_notify(ez::exit_output output) {
+  if (waiter == nullptr) return;
+  pros::c::task_notify_ext(waiter, output, pros::E_NOTIFY_ACTION_OWRITE, nullptr);
+  waiter = nullptr;
+}
+
+static Controller* queue_pop() {
+  if (queue_amount == 0) return nullptr;
+  Controller* out = queued[queue_first];
+  queue_first = (queue_first + 1) % QUEUE_SIZE;
+  queue_amount--;
+  return out;
+}
+
+static void motion_task() {
+  uint32_t now = pros::millis();
+  while (true) {
+    stats.iteration_start();
+
+    lock.take();
+    if (active != nullptr) {
+      // EZ-Template has been given the drive back, or the robot was disabled
+      if (chassis.drive_mode_get() != ez::DISABLE || pros::competition::is_disabled()) {
+        active = nullptr;
+        queue_amount = 0;
+        waiter_notify(exit_state);
+      } else {
+        if (!started) {
+          active->start();
+          timeline::motion_start();
+          started = true;
+        }
+        ez::exit_output output = active->iterate(period / 1000.0);
+
+        // Hand off to the next motion in the same tick so there's no gap
+        if (output != ez::RUNNING && queue_amount > 0) {
+          active = queue_pop();
+          active->start();
+          timeline::motion_start();
+          active->iterate(period / 1000.0);
+        } else if (output != ez::RUNNING && exit_state == ez::RUNNING) {
+          exit_state = output;
+          waiter_notify(exit_state);
+        }
+      }
+    }
+    lock.give();
+
+    stats.iteration_end();
+    pros::Task::delay_until(&now, period);
+  }
+}
+
+void initialize() {
+  stats.period_nominal_set(period);
+  pros::Task task(motion_task, TASK_PRIORITY_DEFAULT + 1, TASK_STACK_DEPTH_DEFAULT, "Motion");
+}
+
+void start(Controller* controller) {
+  // Preparing can take a while, so do it before the motion task can see this motion
+  queue_heading = controller->prepare(chassis.drive_imu_get());
+
+  lock.take();
+  chassis.drive_mode_set(ez::DISABLE, false);
+  active = controller;
+  queue_amount = 0;
+  started = false;
+  exit_state = ez::RUNNING;
+  lock.give();
+}
+
+bool queue(Controller* controller) {
+  if (!running()) {
+    start(controller);
+    return true;
+  }
+  if (queue_amount >= QUEUE_SIZE) return false;
+
+  double heading = controller->prepare(queue_heading);
+
+  lock.take();
+  // The motion ahead could have exited or been stopped while this was preparing
+  bool still_running = active != nullptr && (exit_state == ez::RUNNING || queue_amount > 0);
+  if (still_running) {
+    queued[(queue_first + queue_amount) % QUEUE_SIZE] = controller;
+    queue_amount++;
+    queue_heading = heading;
+  }
+  lock.give();
+
+  if (!still_running) start(controller);
+  return true;
+}
+
+int queue_amount_get() { return queue_amount; }
+
+Controller* current_get() { return active; }
+
+int path_index_get() {
+  lock.take();
+  int out = active != nullptr ? active->path_index_get() : -1;
+  lock.give();
+  return out;
+}
+
+bool in_use(const Controller* controller) {
+  lock.take();
+  bool out = controller == active;
+  for (int i = 0; i < queue_amount && !out; i++) out = queued[(queue_first + i) % QUEUE_SIZE] == controller;
+  lock.give();
+  return out;
+}
+
+void drive_set(double left, double right) { chassis.drive_set(battery::compensate(left), battery::compensate(right)); }
+
+void release() {
+  // The motion task holds the lock while it iterates, so once this has it nothing is reading the old motion
+  lock.take();
+  active = nullptr;
+  queue_amount = 0;
+  waiter_notify(exit_state);
+  lock.give();
+}
+
+void stop() {
+  release();
+  chassis.drive_set(0, 0);
+}
+
+bool running() { return active != nullptr && (exit_state == ez::RUNNING || queue_amount > 0); }
+
+ez::exit_output exit_get() { return exit_state; }
+
+ez::exit_output wait() {
+  lock.take();
+  if (!running()) {
+    lock.give();
+    return exit_state;
+  }
+  // Register before unlocking so the motion task can't exit in between unseen
+  waiter = pros::c::task_get_current();
+  pros::c::task_notify_clear(waiter);
+  lock.give();
+
+  return (ez::exit_output)pros::c::task_notify_take(true, TIMEOUT_MAX);
+}
+
+///
+// PID helpers
+///
+void pid_constants_scaled_set(ez::PID& pid, ez::PID::Constants constants) {
+  double scale = (double)ez::util::DELAY_TIME / period;
+  pid.constants_set(constants.kp, constants.ki / scale, constants.kd * scale, constants.start_i);
+}
+
+void pid_scaled_set(ez::PID& pid, ez::PID& source, ez::PID::Constants constants) {
+  // How many times faster ez::PID's timers run than real time at this period
+  double scale = (double)ez::util::DELAY_TIME / period;
+
+  pid_constants_scaled_set(pid, constants);
+  pid.exit_condition_set(source.exit.small_exit_time * scale, source.exit.small_error,
+                         source.exit.big_exit_time * scale, source.exit.big_error,
+                         source.exit.velocity_exit_time * scale, source.exit.mA_timeout * scale);
+  pid.velocity_sensor_main_exit_set(source.velocity_sensor_main_exit_get() / scale);
+  pid.velocity_sensor_secondary_exit_set(source.velocity_sensor_secondary_exit_get() / scale);
+  pid.i_reset_toggle(source.i_reset_get());
+  pid.variables_reset();
+  pid.timers_reset();
+}
+
+void drive_gain_schedule_set(const GainSchedule& schedule) { drive_schedule = schedule; }
+const GainSchedule& drive_gain_schedule_get() { return drive_schedule; }
+void turn_gain_schedule_set(const GainSchedule& schedule) { turn_schedule = schedule; }
+const GainSchedule& turn_gain_schedule_get() { return turn_schedule; }
+void swing_gain_schedule_set(const GainSchedule& schedule) { swing_schedule = schedule; }
+const GainSchedule& swing_gain_schedule_get() { return swing_schedule; }
+
+// Error schedules are the only ones that change while a motion runs
+static bool error_scheduled(const GainSchedule& schedule) { return schedule.enabled() && schedule.key_get() == GainSchedule::ERROR; }
+
+double angle_target_get(double target, double current, ez::e_angle_behavior behavior) {
+  switch (behavior) {
+    case ez::shortest:
+      return ez::util::turn_shortest(target, current);
+    case ez::longest:
+      return ez::util::turn_longest(target, current);
+    case ez::left_turn:
+      target = current + ez::util::wrap_angle(target - current);
+      return target > current ? target - 360.0 : target;
+    case ez::right_turn:
+      target = current + ez::util::wrap_angle(target - current);
+      return target < current ? target + 360.0 : target;
+    default:
+      return target;
+  }
+}
+
+///
+// Drive PID
+///
+class DrivePID : public Controller {
+ public:
+  double target = 0.0;
+  int speed = 0;
+  bool slew_on = false;
+
+  double prepare(double heading) override {
+    bool forward = target >= 0;
+    ez::PID::Constants constants = forward ? chassis.pid_drive_constants_forward_get() : chassis.pid_drive_constants_backward_get();
+    pid_scaled_set(left, chassis.leftPID, constants);
+    pid_scaled_set(right, chassis.rightPID, constants);
+    if (drive_schedule.enabled()) {
+      pid_constants_scaled_set(left, drive_schedule.motion_get(target, speed));
+      pid_constants_scaled_set(right, drive_schedule.motion_get(target, speed));
+    }
+    pid_scaled_set(heading_pid, chassis.headingPID, chassis.pid_heading_constants_get());
+    left.target_set(target);
+    right.target_set(target);
+    heading_pid.target_set(heading);
+
+    ez::slew::Constants s = (forward ? chassis.slew_forward : chassis.slew_backward).constants_get();
+    slew.constants_set(s.distance_to_travel, s.min_speed);
+    slew.initialize(slew_on, speed, target, 0.0);
+    return heading;
+  }
+
+  void start() override {
+    l_start = chassis.drive_sensor_left();
+    r_start = chassis.drive_sensor_right();
+    l_exit = r_exit = ez::RUNNING;
+  }
+
+  ez::exit_output iterate(double dt) override {
+    double l = chassis.drive_sensor_left() - l_start;
+    double r = chassis.drive_sensor_right() - r_start;
+    double max = slew.iterate((l + r) / 2.0);
+
+    if (error_scheduled(drive_schedule)) {
+      pid_constants_scaled_set(left, drive_schedule.get(left.error));
+      pid_constants_scaled_set(right, drive_schedule.get(right.error));
+    }
+    double l_out = ez::util::clamp(left.compute(l), max);
+    double r_out = ez::util::clamp(right.compute(r), max);
+    double h_out = heading_pid.compute(chassis.drive_imu_get());
+    drive_set(l_out + h_out, r_out - h_out);
+
+    if (l_exit == ez::RUNNING) l_exit = left.exit_condition(chassis.left_motors[0]);
+    if (r_exit == ez::RUNNING) r_exit = right.exit_condition(chassis.right_motors[0]);
+    if (l_exit == ez::RUNNING || r_exit == ez::RUNNING) return ez::RUNNING;
+    return std::max(l_exit, r_exit);
+  }
+
+  ez::e_mode mode_get() override { return ez::DRIVE; }
+  double target_get() override { return target; }
+  double error_get() override { return (left.error + right.error) / 2.0; }
+
+ private:
+  ez::PID left, right, heading_pid;
+  ez::slew slew;
+  double l_start = 0.0, r_start = 0.0;
+  ez::exit_output l_exit = ez::RUNNING, r_exit = ez::RUNNING;
+};
+static Pool<DrivePID> drive_pids;
+
+static DrivePID* drive_pid_get(okapi::QLength target, int speed, bool slew_on) {
+  DrivePID* out = drive_pids.get();
+  out->target = target.convert(okapi::inch);
+  out->speed = abs(speed);
+  out->slew_on = slew_on;
+  return out;
+}
+
+void pid_drive_set(okapi::QLength target, int speed, bool slew_on) { start(drive_pid_get(target, speed, slew_on)); }
+
+bool queue_drive(okapi::QLength target, int speed, bool slew_on) { return queue(drive_pid_get(target, speed, slew_on)); }
+
+///
+// Turn PID
+///
+class TurnPID : public Controller {
+ public:
+  double target = 0.0;
+  int speed = 0;
+  ez::e_angle_behavior behavior = ez::raw;
+
+  double prepare(double heading) override {
+    pid_scaled_set(turn, chassis.turnPID, chassis.pid_turn_constants_get());
+    turn.target_set(angle_target_get(target, heading, behavior));
+    if (turn_schedule.enabled())
+      pid_constants_scaled_set(turn, turn_schedule.motion_get(turn.target_get() - heading, speed));
+
+    ez::slew::Constants s = chassis.slew_turn.constants_get();
+    slew.constants_set(s.distance_to_travel, s.min_speed);
+    slew.initialize(chassis.slew_turn_get(), speed, turn.target_get(), heading);
+    return turn.target_get();
+  }
+
+  ez::exit_output iterate(double dt) override {
+    double current = chassis.drive_imu_get();
+    if (error_scheduled(turn_schedule)) pid_constants_scaled_set(turn, turn_schedule.get(turn.error));
+    double out = ez::util::clamp(turn.compute(current), slew.iterate(current));
+    drive_set(out, -out);
+    return turn.exit_condition({chassis.left_motors[0], chassis.right_motors[0]});
+  }
+
+  ez::e_mode mode_get() override { return ez::TURN; }
+  double target_get() override { return turn.target_get(); }
+  double error_get() override { return turn.error; }
+
+ private:
+  ez::PID turn;
+  ez::slew slew;
+};
+static Pool<TurnPID> turn_pids;
+
+static TurnPID* turn_pid_get(okapi::QAngle target, int speed, ez::e_angle_behavior behavior) {
+  TurnPID* out = turn_pids.get();
+  out->target = target.convert(okapi::degree);
+  out->speed = abs(speed);
+  out->behavior = behavior;
+  return out;
+}
+
+void pid_turn_set(okapi::QAngle target, int speed, ez::e_angle_behavior behavior) { start(turn_pid_get(target, speed, behavior)); }
+
+void pid_turn_set(okapi::QAngle target, int speed) { pid_turn_set(target, speed, chassis.pid_turn_behavior_get()); }
+
+bool queue_turn(okapi::QAngle target, int speed, ez::e_angle_behavior behavior) { return queue(turn_pid_get(target, speed, behavior)); }
+
+bool queue_turn(okapi::QAngle target, int speed) { return queue_turn(target, speed, chassis.pid_turn_behavior_get()); }
+
+///
+// Swing PID
+///
+class SwingPID : public Controller {
+ public:
+  ez::e_swing type = ez::LEFT_SWING;
+  double target = 0.0;
+  int speed = 0;
+  int opposite_speed = 0;
+
+  double prepare(double heading) override {
+    double new_target = angle_target_get(target, heading, chassis.pid_swing_behavior_get());
+
+    // A swing that turns clockwise drives the left side forward or the right side backward
+    bool forward = (new_target > heading) == (type == ez::LEFT_SWING);
+    ez::PID::Constants constants = forward ? chassis.pid_swing_constants_forward_get() : chassis.pid_swing_constants_backward_get();
+    pid_scaled_set(swing, chassis.swingPID, constants);
+    swing.target_set(new_target);
+    if (swing_schedule.enabled())
+      pid_constants_scaled_set(swing, swing_schedule.motion_get(new_target - heading, speed));
+    return new_target;
+  }
+
+  ez::exit_output iterate(double dt) override {
+    if (error_scheduled(swing_schedule)) pid_constants_scaled_set(swing, swing_schedule.get(swing.error));
+    double out = ez::util::clamp(swing.compute(chassis.drive_imu_get()), speed);
+    double opposite = opposite_speed * ez::util::sgn(out);
+    if (type == ez::LEFT_SWING) {
+      drive_set(out, opposite);
+      return swing.exit_condition(chassis.left_motors[0]);
+    }
+    drive_set(-opposite, -out);
+    return swing.exit_condition(chassis.right_motors[0]);
+  }
+
+  ez::e_mode mode_get() override { return ez::SWING; }
+  double target_get() override { return swing.target_get(); }
+  double error_get() override { return swing.error; }
+
+ private:
+  ez::PID swing;
+};
+static Pool<SwingPID> swing_pids;
+
+static SwingPID* swing_pid_get(ez::e_swing type, okapi::QAngle target, int speed, int opposite_speed) {
+  SwingPID* out = swing_pids.get();
+  out->type = type;
+  out->target = target.convert(okapi::degree);
+  out->speed = abs(speed);
+  out->opposite_speed = abs(opposite_speed);
+  return out;
+}
+
+void pid_swing_set(ez::e_swing type, okapi::QAngle target, int speed, int opposite_speed) { start(swing_pid_get(type, target, speed, opposite_speed)); }
+
+bool queue_swing(ez::e_swing type, okapi::QAngle target, int speed, int opposite_speed) { return queue(swing_pid_get(type, target, speed, opposite_speed)); }
+}  // namespace motion
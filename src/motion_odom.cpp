@@ -0,0 +1,465 @@
+#include "motion.hpp"
+
+#include "odometry.hpp"
+#include "okapi/squiggles/squiggles.hpp"
+#include "path_cache.hpp"
+#include "subsystems.hpp"
+
+namespace motion {
+static double smooth_weight_smooth = 0.75;
+static double smooth_weight_data = 0.03;
+static double smooth_tolerance = 0.0001;
+static PurePursuitAdaptive adaptive_constants;
+static bool adaptive_enabled = false;
+
+void path_smooth_constants_set(double weight_smooth, double weight_data, double tolerance) {
+  smooth_weight_smooth = weight_smooth;
+  smooth_weight_data = weight_data;
+  smooth_tolerance = tolerance;
+}
+
+void path_smooth(Path& path) { path.smooth(smooth_weight_smooth, smooth_weight_data, smooth_tolerance); }
+
+void pp_adaptive_constants_set(PurePursuitAdaptive constants) { adaptive_constants = constants; }
+PurePursuitAdaptive pp_adaptive_constants_get() { return adaptive_constants; }
+
+void pp_adaptive_toggle(bool toggle) { adaptive_enabled = toggle; }
+bool pp_adaptive_enabled() { return adaptive_enabled; }
+
+static ez::pose pose_get(const Path::point& p) { return {p.x, p.y, ez::ANGLE_NOT_SET}; }
+
+///
+// Pure pursuit
+///
+class PurePursuit : public Controller {
+ public:
+  const Path* path = nullptr;
+
+  double prepare(double heading) override {
+    look_ahead = chassis.odom_look_ahead_get();
+    turn_bias = chassis.odom_turn_bias_get();
+    adaptive = adaptive_enabled;
+    constants = adaptive_constants;
+    ff = drive_feedforward_get();
+    spacing = chassis.odom_path_spacing_get();
+    double widest = adaptive ? constants.look_ahead_max : look_ahead;
+    window = spacing > 0.0 ? std::max(4, (int)ceil(2.0 * widest / spacing)) : 4;
+
+    // Enough points ahead to slow down from full speed for a corner
+    brake_window = window;
+    if (adaptive && ff.kV > 0.0 && constants.deceleration > 0.0 && spacing > 0.0) {
+      double full_speed = (127.0 - ff.kS) / ff.kV;
+      brake_window = std::max(window, (int)ceil(full_speed * full_speed / (2.0 * constants.deceleration) / spacing));
+    }
+    pid_scaled_set(xy, chassis.xyPID, chassis.pid_drive_constants_forward_get());
+    pid_scaled_set(angular, chassis.odom_angularPID, chassis.odom_angularPID.constants_get());
+
+    // The robot ends facing along the last segment
+    int n = path->amount();
+    if (n < 2) return heading;
+    const Path::point& end = (*path)[n - 1];
+    double end_heading = ez::util::absolute_angle_to_point(pose_get(end), pose_get((*path)[n - 2]));
+    if (end.direction == ez::REV) end_heading += 180.0;
+    return heading + ez::util::wrap_angle(end_heading - heading);
+  }
+
+  void start() override {
+    closest = 0;
+    target = 0;
+    lost = false;
+    holding = false;
+    l_last = chassis.drive_sensor_left();
+    r_last = chassis.drive_sensor_right();
+    speed = 0.0;
+    travelled = 0.0;
+  }
+
+  ez::exit_output iterate(double dt) override {
+    int n = path->amount();
+    if (n == 0) {
+      drive_set(0, 0);
+      return ez::SMALL_EXIT;
+    }
+    ez::pose pose = odometry::pose_get();
+
+    // Lightly filtered so one noisy loop doesn't jump the look ahead
+    double l = chassis.drive_sensor_left(), r = chassis.drive_sensor_right();
+    double moved = ((l - l_last) + (r - r_last)) / 2.0;
+    if (dt > 0.0) speed += 0.3 * (moved / dt - speed);
+    l_last = l;
+    r_last = r;
+    if (adaptive)
+      look_ahead = ez::util::clamp(constants.look_ahead_min + fabs(speed) * constants.look_ahead_time, constants.look_ahead_max, constants.look_ahead_min);
+
+    // Both cursors only move forward while on the path, so each loop only looks at a few points
+    closest_update(pose, n);
+    if (target < closest || lost) target = closest;
+    while (target < n - 1 && ez::util::distance_to_point(pose_get((*path)[target]), pose) < look_ahead)
+      target++;
+
+    const Path::point& p = (*path)[target];
+    const Path::point& end = (*path)[n - 1];
+    double to_end = ez::util::distance_to_point(pose_get(end), pose);
+    int direction = p.direction == ez::REV ? -1 : 1;
+    travelled += direction * moved;
+    double max_speed = adaptive ? fmin(p.speed, speed_cap_get(n)) : p.speed;
+
+    // Aim at the look ahead point until close to the end, then hold that heading
+    double aim = ez::util::absolute_angle_to_point(pose_get(p), pose);
+    if (direction < 0) aim += 180.0;
+    if (!holding && target == n - 1 && to_end < look_ahead / 2.0) {
+      holding = true;
+      hold_heading = aim;
+      xy.timers_reset();
+    }
+    if (holding) aim = hold_heading;
+    double angle_error = ez::util::wrap_angle(aim - pose.theta);
+
+    // Far from the end this just saturates, at the end it's how far the end is along the robot
+    double xy_error = to_end * cos(ez::util::to_rad(angle_error));
+    if (holding) {
+      double along = (end.x - pose.x) * sin(ez::util::to_rad(pose.theta)) + (end.y - pose.y) * cos(ez::util::to_rad(pose.theta));
+      xy_error = along * direction;
+    }
+    // D and the velocity exit work off how far the robot has driven the way the path goes
+    double xy_out = direction * ez::util::clamp(xy.compute_error(xy_error, travelled), max_speed);
+    double a_out = ez::util::clamp(angular.compute_error(angle_error, pose.theta), max_speed);
+
+    // Turning gets up to turn_bias of the speed, driving gets what's left
+    if (fabs(xy_out) + fabs(a_out) > max_speed) {
+      a_out = ez::util::sgn(a_out) * fmin(fabs(a_out), max_speed * turn_bias);
+      xy_out = ez::util::sgn(xy_out) * (max_speed - fabs(a_out));
+    }
+    drive_set(xy_out + a_out, xy_out - a_out);
+
+    if (!holding) return ez::RUNNING;
+    return xy.exit_condition({chassis.left_motors[0], chassis.right_motors[0]});
+  }
+
+  ez::e_mode mode_get() override { return ez::PURE_PURSUIT; }
+  double error_get() override { return xy.error; }
+  int path_index_get() override { return path->amount() > 0 ? (*path)[closest].index : -1; }
+
+ private:
+  // The fastest the robot can go now and still take every corner ahead within the lateral acceleration limit
+  double speed_cap_get(int n) {
+    if (ff.kV <= 0.0 || constants.lateral_acceleration <= 0.0) return 127.0;
+    double cap = INFINITY;
+    int last = std::min(n - 1, closest + brake_window);
+    for (int i = closest; i <= last; i++) {
+      double curvature = fabs((*path)[i].curvature);
+      if (curvature < 1e-6) continue;
+      double corner = constants.lateral_acceleration / curvature;
+      double ahead = (i - closest) * spacing;
+      cap = fmin(cap, sqrt(corner + 2.0 * constants.deceleration * ahead));
+    }
+    return cap == INFINITY ? 127.0 : ff.compute(cap, 0.0);
+  }
+
+  // Finds the closest point in a window ahead of the last one.  If the robot is
+  // further than the look ahead from all of those it's been knocked off the path.
+  // Then the last closest point follows the path either way to the nearest point
+  // on that part of it, and the whole path is searched once.  Another part of the
+  // path has to be closer by the look ahead to win, so a route that passes near
+  // itself doesn't skip ahead.  Until the robot is back within half the look
+  // ahead, the closest point only steps to a closer neighbour.
+  void closest_update(ez::pose pose, int n) {
+    if (lost) {
+      if (closest_descend(pose, n) <= look_ahead / 2.0) lost = false;
+      return;
+    }
+
+    int from = closest, last = std::min(n - 1, closest + window);
+    double best = point_distance_get(closest, pose);
+    for (int i = closest + 1; i <= last; i++) {
+      double distance = point_distance_get(i, pose);
+      if (distance < best) {
+        best = distance;
+        closest = i;
+      }
+    }
+    if (best <= look_ahead) return;
+
+    lost = true;
+    closest = from;
+    double local = best = closest_descend(pose, n);
+    for (int i = 0; i < n; i++) {
+      double distance = point_distance_get(i, pose);
+      if (distance < local - look_ahead && distance < best) {
+        best = distance;
+        closest = i;
+      }
+    }
+  }
+
+  // Steps the closest point to whichever neighbour is closer until neither is
+  double closest_descend(ez::pose pose, int n) {
+    double best = point_distance_get(closest, pose);
+    while (true) {
+      double behind = closest > 0 ? point_distance_get(closest - 1, pose) : INFINITY;
+      double ahead = closest < n - 1 ? point_distance_get(closest + 1, pose) : INFINITY;
+      if (fmin(behind, ahead) >= best) return best;
+      closest += ahead < behind ? 1 : -1;
+      best = fmin(behind, ahead);
+    }
+  }
+
+  double point_distance_get(int i, ez::pose pose) { return ez::util::distance_to_point(pose_get((*path)[i]), pose); }
+
+  ez::PID xy, angular;
+  double look_ahead = 0.0, turn_bias = 0.0;
+  int window = 4, brake_window = 4;
+  bool adaptive = false;
+  PurePursuitAdaptive constants;
+  Feedforward ff;
+  double spacing = 0.0;
+  double l_last = 0.0, r_last = 0.0, speed = 0.0, travelled = 0.0;
+  int closest = 0, target = 0;
+  bool lost = false;
+  bool holding = false;
+  double hold_heading = 0.0;
+};
+static Pool<PurePursuit> pure_pursuits;
+
+static PurePursuit* pure_pursuit_get(const Path& path) {
+  PurePursuit* out = pure_pursuits.get();
+  out->path = &path;
+  return out;
+}
+
+void pid_odom_pp_set(const Path& path) { start(pure_pursuit_get(path)); }
+
+bool queue_odom_pp(const Path& path) { return queue(pure_pursuit_get(path)); }
+
+bool pid_odom_pp_set(int path_id) {
+  Path* path = paths::get(path_id);
+  if (path == nullptr) return false;
+  pid_odom_pp_set(*path);
+  return true;
+}
+
+bool queue_odom_pp(int path_id) {
+  Path* path = paths::get(path_id);
+  return path != nullptr && queue_odom_pp(*path);
+}
+
+///
+// Trajectories
+///
+static const double METERS_PER_INCH = 0.0254;
+static double ramsete_b = 2.0;
+static double ramsete_zeta = 0.7;
+static double ramsete_velocity_p = 0.0;
+
+void ramsete_constants_set(double b, double zeta, double velocity_p) {
+  ramsete_b = b;
+  ramsete_zeta = zeta;
+  ramsete_velocity_p = velocity_p;
+}
+
+class Ramsete : public Controller {
+ public:
+  const Trajectory* trajectory = nullptr;
+
+  double prepare(double heading) override {
+    b = ramsete_b;
+    zeta = ramsete_zeta;
+    velocity_p = ramsete_velocity_p;
+    ff = drive_feedforward_get();
+    width = chassis.drive_width_get();
+    pid_scaled_set(exit_pid, chassis.xyPID, chassis.pid_drive_constants_forward_get());
+
+    int n = trajectory->amount();
+    if (n == 0) return heading;
+    return heading + ez::util::wrap_angle((*trajectory)[n - 1].theta - heading);
+  }
+
+  void start() override {
+    start_time = pros::micros();
+    settling = false;
+    l_last = chassis.drive_sensor_left();
+    r_last = chassis.drive_sensor_right();
+    l_speed = r_speed = 0.0;
+  }
+
+  ez::exit_output iterate(double dt) override {
+    double l = chassis.drive_sensor_left(), r = chassis.drive_sensor_right();
+    if (dt > 0.0) {
+      l_speed += 0.5 * ((l - l_last) / dt - l_speed);
+      r_speed += 0.5 * ((r - r_last) / dt - r_speed);
+    }
+    l_last = l;
+    r_last = r;
+
+    if (trajectory->amount() == 0) {
+      drive_set(0, 0);
+      return ez::SMALL_EXIT;
+    }
+
+    // Sample by the clock so a late loop doesn't fall behind
+    double t = (pros::micros() - start_time) / 1000000.0;
+    Trajectory::point ref = trajectory->sample((*trajectory)[0].time + t);
+    index = trajectory->index_get(ref.time);
+    ez::pose pose = odometry::pose_get();
+
+    // Error in the robot's frame, in meters and radians counterclockwise like RAMSETE is written
+    double theta = ez::util::to_rad(pose.theta);
+    double dx = (ref.x - pose.x) * METERS_PER_INCH;
+    double dy = (ref.y - pose.y) * METERS_PER_INCH;
+    double e_forward = dx * sin(theta) + dy * cos(theta);
+    double e_left = -dx * cos(theta) + dy * sin(theta);
+    double e_theta = -ez::util::to_rad(ez::util::wrap_angle(ref.theta - pose.theta));
+    error = hypot(ref.x - pose.x, ref.y - pose.y);
+
+    double v_ref = ref.velocity * METERS_PER_INCH;
+    double w_ref = -ref.velocity * ref.curvature;  // rad/s counterclockwise
+    double k = 2.0 * zeta * sqrt(w_ref * w_ref + b * v_ref * v_ref);
+    double sinc = fabs(e_theta) < 1e-6 ? 1.0 : sin(e_theta) / e_theta;
+    double v = (v_ref * cos(e_theta) + k * e_forward) / METERS_PER_INCH;
+    double w = -(w_ref + k * e_theta + b * v_ref * sinc * e_left);  // rad/s clockwise
+
+    // Each side's speed and acceleration, then feedforward turns them into output
+    double half = width / 2.0;
+    double l_target = v + w * half, r_target = v - w * half;
+    double l_out = ff.compute(l_target, ref.acceleration * (1.0 + ref.curvature * half)) + velocity_p * (l_target - l_speed);
+    double r_out = ff.compute(r_target, ref.acceleration * (1.0 - ref.curvature * half)) + velocity_p * (r_target - r_speed);
+    double biggest = fmax(fabs(l_out), fabs(r_out));
+    if (biggest > 127.0) {
+      l_out *= 127.0 / biggest;
+      r_out *= 127.0 / biggest;
+    }
+    drive_set(l_out, r_out);
+
+    // The trajectory is only done once it's run its course, the exit conditions settle it from there
+    if (t < trajectory->duration()) return ez::RUNNING;
+    if (!settling) {
+      exit_pid.timers_reset();
+      settling = true;
+    }
+    // The measurement is how far the drive has gone, so the velocity exit sees the robot still moving
+    exit_pid.compute_error(e_forward / METERS_PER_INCH, (l + r) / 2.0);
+    return exit_pid.exit_condition({chassis.left_motors[0], chassis.right_motors[0]});
+  }
+
+  ez::e_mode mode_get() override { return ez::PURE_PURSUIT; }
+  double error_get() override { return error; }
+  double duration_predicted_get() override { return trajectory->duration(); }
+  int path_index_get() override { return index; }
+
+ private:
+  ez::PID exit_pid;
+  Feedforward ff;
+  double b = 0.0, zeta = 0.0, velocity_p = 0.0, width = 0.0;
+  double l_last = 0.0, r_last = 0.0, l_speed = 0.0, r_speed = 0.0;
+  uint64_t start_time = 0;
+  bool settling = false;
+  double error = 0.0;
+  int index = -1;
+};
+static Pool<Ramsete> ramsetes;
+
+static Ramsete* ramsete_get(const Trajectory& trajectory) {
+  Ramsete* out = ramsetes.get();
+  out->trajectory = &trajectory;
+  return out;
+}
+
+void pid_odom_trajectory_set(const Trajectory& trajectory) { start(ramsete_get(trajectory)); }
+
+bool queue_odom_trajectory(const Trajectory& trajectory) { return queue(ramsete_get(trajectory)); }
+
+// 360rpm on 3.25in wheels tops out around 61in/s
+static MotionProfile::constraints spline_limits = {55.0, 100.0, 0.0};
+static const double SPLINE_DT = 0.01;
+
+void spline_constraints_set(MotionProfile::constraints limits) { spline_limits = limits; }
+MotionProfile::constraints spline_constraints_get() { return spline_limits; }
+
+// EZ-Template poses in inches and degrees to squiggles poses in meters and radians counterclockwise from +x
+static squiggles::Pose squiggles_pose_get(double x, double y, double theta) {
+  return squiggles::Pose(x * METERS_PER_INCH, y * METERS_PER_INCH, ez::util::to_rad(90.0 - theta));
+}
+
+bool spline_generate(Trajectory& storage, ez::pose start, std::span<const ez::united_pose> waypoints) {
+  storage.clear();
+  if (waypoints.empty()) return false;
+
+  std::vector<squiggles::Pose> poses;
+  poses.reserve(waypoints.size() + 1);
+  poses.push_back(squiggles_pose_get(start.x, start.y, start.theta));
+  ez::pose last = start;
+  for (size_t i = 0; i < waypoints.size(); i++) {
+    ez::pose p = {waypoints[i].x.convert(okapi::inch), waypoints[i].y.convert(okapi::inch), waypoints[i].theta.convert(okapi::degree)};
+
+    // Face the next point, or the last point faces the way it came in
+    if (waypoints[i].theta == ez::p_ANGLE_NOT_SET) {
+      if (i + 1 < waypoints.size())
+        p.theta = ez::util::absolute_angle_to_point({waypoints[i + 1].x.convert(okapi::inch), waypoints[i + 1].y.convert(okapi::inch)}, p);
+      else
+        p.theta = ez::util::absolute_angle_to_point(p, last);
+    }
+    poses.push_back(squiggles_pose_get(p.x, p.y, p.theta));
+    last = p;
+  }
+
+  double jerk = spline_limits.jerk > 0.0 ? spline_limits.jerk * METERS_PER_INCH : std::numeric_limits<double>::max();
+  squiggles::Constraints limits(spline_limits.velocity * METERS_PER_INCH, spline_limits.acceleration * METERS_PER_INCH, jerk);
+
+  // Squiggles throws when it can't fit a spline, and allocating can throw too
+  try {
+    squiggles::SplineGenerator generator(limits, std::make_shared<squiggles::TankModel>(chassis.drive_width_get() * METERS_PER_INCH, limits), SPLINE_DT);
+    std::vector<squiggles::ProfilePoint> points = generator.generate(poses);
+    return !points.empty() && storage.build(points);
+  } catch (const std::exception& e) {
+    printf("spline_generate: %s\n", e.what());
+    storage.clear();
+    return false;
+  }
+}
+
+// Each of these releases the current motion first, it could be holding onto the storage that's about to be rewritten
+bool pid_odom_spline_set(Trajectory& storage, std::span<const ez::united_pose> waypoints) {
+  release();
+  if (!spline_generate(storage, odometry::pose_get(), waypoints)) return false;
+  pid_odom_trajectory_set(storage);
+  return true;
+}
+
+bool pid_odom_spline_set(Trajectory& storage, std::initializer_list<ez::united_pose> waypoints) {
+  return pid_odom_spline_set(storage, std::span<const ez::united_pose>(waypoints.begin(), waypoints.size()));
+}
+
+bool pid_odom_injected_pp_set(Path& storage, std::span<const ez::odom> input) {
+  release();
+  if (!storage.build(odometry::pose_get(), input, chassis.odom_path_spacing_get())) return false;
+  pid_odom_pp_set(storage);
+  return true;
+}
+
+bool pid_odom_injected_pp_set(Path& storage, std::initializer_list<ez::odom> input) {
+  return pid_odom_injected_pp_set(storage, std::span<const ez::odom>(input.begin(), input.size()));
+}
+
+bool pid_odom_smooth_pp_set(Path& storage, std::span<const ez::odom> input) {
+  release();
+  if (!storage.build(odometry::pose_get(), input, chassis.odom_path_spacing_get())) return false;
+  path_smooth(storage);
+  pid_odom_pp_set(storage);
+  return true;
+}
+
+bool pid_odom_smooth_pp_set(Path& storage, std::initializer_list<ez::odom> input) {
+  return pid_odom_smooth_pp_set(storage, std::span<const ez::odom>(input.begin(), input.size()));
+}
+
+bool pid_odom_spline_pp_set(Path& storage, std::span<const ez::odom> input) {
+  release();
+  if (!storage.build_spline(odometry::pose_get(), input, chassis.odom_path_spacing_get())) return false;
+  pid_odom_pp_set(storage);
+  return true;
+}
+
+bool pid_odom_spline_pp_set(Path& storage, std::initializer_list<ez::odom> input) {
+  return pid_odom_spline_pp_set(storage, std::span<const ez::odom>(input.begin(), input.size()));
+}
+}  // namespace motion
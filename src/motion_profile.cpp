@@ -0,0 +1,96 @@
+#include "motion_profile.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+MotionProfile::MotionProfile() {}
+
+MotionProfile::MotionProfile(double distance, constraints limits) { generate(distance, limits); }
+
+// Distance covered speeding up from 0 to v, and the acceleration actually reached
+static double accel_distance(double v, double a_max, double jerk, double* a_used) {
+  if (jerk <= 0.0) {
+    *a_used = a_max;
+    return v * v / (2.0 * a_max);
+  }
+  // If v is low the acceleration never gets to its limit before it has to ramp back down
+  double a = std::min(a_max, std::sqrt(v * jerk));
+  *a_used = a;
+  return v / 2.0 * (v / a + a / jerk);
+}
+
+void MotionProfile::segment_add(double duration, double acceleration, double jerk, state* current, double* t) {
+  if (duration <= 0.0) return;
+  current->acceleration = acceleration;
+  segments[amount++] = {*t, jerk, *current};
+
+  // Integrate the segment to find where the next one starts
+  double v = current->velocity, a = acceleration;
+  current->position += v * duration + a * duration * duration / 2.0 + jerk * duration * duration * duration / 6.0;
+  current->velocity += a * duration + jerk * duration * duration / 2.0;
+  current->acceleration = a + jerk * duration;
+  *t += duration;
+}
+
+void MotionProfile::generate(double distance, constraints limits) {
+  amount = 0;
+  sign = distance < 0 ? -1 : 1;
+  total_distance = std::fabs(distance);
+  double d = total_distance;
+  double j = limits.jerk;
+
+  // Lower the peak velocity until speeding up and slowing down fit in the distance
+  double v = limits.velocity, a = limits.acceleration;
+  if (2.0 * accel_distance(v, limits.acceleration, j, &a) > d) {
+    double low = 0.0, high = v;
+    for (int i = 0; i < 40; i++) {
+      double mid = (low + high) / 2.0;
+      if (2.0 * accel_distance(mid, limits.acceleration, j, &a) > d)
+        high = mid;
+      else
+        low = mid;
+    }
+    v = low;
+  }
+  double d_accel = accel_distance(v, limits.acceleration, j, &a);
+
+  double ramp = j > 0.0 ? a / j : 0.0;                   // time spent changing acceleration
+  double hold = v > 0.0 ? std::max(v / a - ramp, 0.0) : 0.0;  // time at constant acceleration
+  double cruise = v > 0.0 ? (d - 2.0 * d_accel) / v : 0.0;
+
+  state current = {0.0, 0.0, 0.0};
+  double t = 0.0;
+  if (j > 0.0) {
+    segment_add(ramp, 0.0, j, &current, &t);
+    segment_add(hold, a, 0.0, &current, &t);
+    segment_add(ramp, a, -j, &current, &t);
+    segment_add(cruise, 0.0, 0.0, &current, &t);
+    segment_add(ramp, 0.0, -j, &current, &t);
+    segment_add(hold, -a, 0.0, &current, &t);
+    segment_add(ramp, -a, j, &current, &t);
+  } else {
+    segment_add(hold, a, 0.0, &current, &t);
+    segment_add(cruise, 0.0, 0.0, &current, &t);
+    segment_add(hold, -a, 0.0, &current, &t);
+  }
+  total_time = t;
+}
+
+MotionProfile::state MotionProfile::sample(double t) {
+  if (amount == 0 || t >= total_time) return {sign * total_distance, 0.0, 0.0};
+  if (t <= 0.0) return {0.0, 0.0, 0.0};
+
+  int i = amount - 1;
+  while (i > 0 && segments[i].start > t) i--;
+  segment s = segments[i];
+  double dt = t - s.start;
+  state out;
+  out.position = s.begin.position + s.begin.velocity * dt + s.begin.acceleration * dt * dt / 2.0 + s.jerk * dt * dt * dt / 6.0;
+  out.velocity = s.begin.velocity + s.begin.acceleration * dt + s.jerk * dt * dt / 2.0;
+  out.acceleration = s.begin.acceleration + s.jerk * dt;
+  return {sign * out.position, sign * out.velocity, sign * out.acceleration};
+}
+
+double MotionProfile::duration() { return total_time; }
+
+double MotionProfile::distance() { return sign * total_distance; }
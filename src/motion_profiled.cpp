@@ -0,0 +1,248 @@
+#include "motion.hpp"
+
+#include "subsystems.hpp"
+
+namespace motion {
+static Feedforward drive_ff;
+static ez::PID::Constants residual_constants;
+static MotionProfile::constraints drive_limits = {50.0, 100.0, 0.0};
+
+static Feedforward turn_ff, swing_ff;
+static double turn_kp = 0.0, turn_kd = 0.0;
+static double swing_kp = 0.0, swing_kd = 0.0;
+static MotionProfile::constraints turn_limits = {360.0, 1500.0, 0.0};
+static MotionProfile::constraints swing_limits = {250.0, 1000.0, 0.0};
+static bool turn_profiled_default = false;
+
+double Feedforward::compute(double velocity, double acceleration) const {
+  // Static friction pushes against the way the robot is moving, or is about to move
+  double direction = velocity != 0.0 ? ez::util::sgn(velocity) : ez::util::sgn(acceleration);
+  return kS * direction + kV * velocity + kA * acceleration;
+}
+
+void drive_feedforward_set(double kS, double kV, double kA) { drive_ff = {kS, kV, kA}; }
+Feedforward drive_feedforward_get() { return drive_ff; }
+
+void pid_profiled_drive_constants_set(double p, double i, double d, double start_i) { residual_constants = {p, i, d, start_i}; }
+
+void profiled_drive_constraints_set(MotionProfile::constraints limits) { drive_limits = limits; }
+MotionProfile::constraints profiled_drive_constraints_get() { return drive_limits; }
+
+void turn_feedforward_set(double kS, double kV, double kA) { turn_ff = {kS, kV, kA}; }
+Feedforward turn_feedforward_get() { return turn_ff; }
+void swing_feedforward_set(double kS, double kV, double kA) { swing_ff = {kS, kV, kA}; }
+Feedforward swing_feedforward_get() { return swing_ff; }
+
+void pid_profiled_turn_constants_set(double p, double d) {
+  turn_kp = p;
+  turn_kd = d;
+}
+void pid_profiled_swing_constants_set(double p, double d) {
+  swing_kp = p;
+  swing_kd = d;
+}
+
+void profiled_turn_constraints_set(MotionProfile::constraints limits) { turn_limits = limits; }
+MotionProfile::constraints profiled_turn_constraints_get() { return turn_limits; }
+void profiled_swing_constraints_set(MotionProfile::constraints limits) { swing_limits = limits; }
+MotionProfile::constraints profiled_swing_constraints_get() { return swing_limits; }
+
+void profiled_turn_toggle(bool toggle) { turn_profiled_default = toggle; }
+bool profiled_turn_enabled() { return turn_profiled_default; }
+
+///
+// Profiled drive
+///
+class ProfiledDrive : public Controller {
+ public:
+  double target = 0.0;
+  MotionProfile::constraints limits;
+
+  double prepare(double heading) override {
+    profile.generate(target, limits);
+
+    pid_scaled_set(left, chassis.leftPID, residual_constants);
+    pid_scaled_set(right, chassis.rightPID, residual_constants);
+    pid_scaled_set(heading_pid, chassis.headingPID, chassis.pid_heading_constants_get());
+    heading_pid.target_set(heading);
+    return heading;
+  }
+
+  void start() override {
+    l_start = chassis.drive_sensor_left();
+    r_start = chassis.drive_sensor_right();
+    start_time = pros::micros();
+    settling = false;
+    l_exit = r_exit = ez::RUNNING;
+  }
+
+  ez::exit_output iterate(double dt) override {
+    // Sample by the clock instead of counting periods so a late loop doesn't fall behind
+    double t = (pros::micros() - start_time) / 1000000.0;
+    MotionProfile::state s = profile.sample(t);
+
+    double l = chassis.drive_sensor_left() - l_start;
+    double r = chassis.drive_sensor_right() - r_start;
+    double ff = drive_ff.compute(s.velocity, s.acceleration);
+    // Measured as how far past the profile each side is, so D damps the tracking error and not the speed feedforward asked for
+    double l_out = ff + left.compute_error(s.position - l, l - s.position);
+    double r_out = ff + right.compute_error(s.position - r, r - s.position);
+    double h_out = heading_pid.compute(chassis.drive_imu_get());
+    drive_set(l_out + h_out, r_out - h_out);
+
+    // The profile is only done once it's run its course, the PID settles it from there
+    if (t < profile.duration()) return ez::RUNNING;
+    if (!settling) {
+      left.timers_reset();
+      right.timers_reset();
+      settling = true;
+    }
+    if (l_exit == ez::RUNNING) l_exit = left.exit_condition(chassis.left_motors[0]);
+    if (r_exit == ez::RUNNING) r_exit = right.exit_condition(chassis.right_motors[0]);
+    if (l_exit == ez::RUNNING || r_exit == ez::RUNNING) return ez::RUNNING;
+    return std::max(l_exit, r_exit);
+  }
+
+  ez::e_mode mode_get() override { return ez::DRIVE; }
+  double target_get() override { return target; }
+  double error_get() override { return (left.error + right.error) / 2.0; }
+  double duration_predicted_get() override { return profile.duration(); }
+
+ private:
+  MotionProfile profile;
+  ez::PID left, right, heading_pid;
+  double l_start = 0.0, r_start = 0.0;
+  uint64_t start_time = 0;
+  bool settling = false;
+  ez::exit_output l_exit = ez::RUNNING, r_exit = ez::RUNNING;
+};
+static Pool<ProfiledDrive> profiled_drives;
+
+static ProfiledDrive* profiled_drive_get(okapi::QLength target, MotionProfile::constraints limits) {
+  ProfiledDrive* out = profiled_drives.get();
+  out->target = target.convert(okapi::inch);
+  out->limits = limits;
+  return out;
+}
+
+void pid_profiled_drive_set(okapi::QLength target, MotionProfile::constraints limits) { start(profiled_drive_get(target, limits)); }
+
+void pid_profiled_drive_set(okapi::QLength target) { pid_profiled_drive_set(target, drive_limits); }
+
+bool queue_profiled_drive(okapi::QLength target, MotionProfile::constraints limits) { return queue(profiled_drive_get(target, limits)); }
+
+bool queue_profiled_drive(okapi::QLength target) { return queue_profiled_drive(target, drive_limits); }
+
+///
+// Profiled turn and swing
+///
+// The gyro follows the right hand rule with z up, so it's counterclockwise positive
+static double gyro_rate_get() { return -chassis.imu.get_gyro_rate().z * chassis.drive_imu_scaler_get(); }
+
+class ProfiledTurn : public Controller {
+ public:
+  bool swing = false;
+  ez::e_swing type = ez::LEFT_SWING;
+  double target = 0.0;
+  MotionProfile::constraints limits;
+  ez::e_angle_behavior behavior = ez::raw;
+
+  double prepare(double heading) override {
+    new_target = angle_target_get(target, heading, swing ? chassis.pid_swing_behavior_get() : behavior);
+    profile.generate(new_target - heading, limits);
+
+    // This PID's output isn't used, it's only here for the chassis exit conditions
+    if (swing)
+      pid_scaled_set(exit_pid, chassis.swingPID, chassis.pid_swing_constants_forward_get());
+    else
+      pid_scaled_set(exit_pid, chassis.turnPID, chassis.pid_turn_constants_get());
+    exit_pid.target_set(new_target);
+    return new_target;
+  }
+
+  void start() override {
+    start_time = pros::micros();
+    settling = false;
+  }
+
+  ez::exit_output iterate(double dt) override {
+    double t = (pros::micros() - start_time) / 1000000.0;
+    MotionProfile::state s = profile.sample(t);
+
+    // The profile is relative to where this motion expected to start
+    double reference = new_target - profile.distance() + s.position;
+    double current = chassis.drive_imu_get();
+    double kp = swing ? swing_kp : turn_kp;
+    double kd = swing ? swing_kd : turn_kd;
+    double out = (swing ? swing_ff : turn_ff).compute(s.velocity, s.acceleration);
+    out += kp * (reference - current) + kd * (s.velocity - gyro_rate_get());
+    exit_pid.compute(current);
+
+    if (!swing)
+      drive_set(out, -out);
+    else if (type == ez::LEFT_SWING)
+      drive_set(out, 0);
+    else
+      drive_set(0, -out);
+
+    if (t < profile.duration()) return ez::RUNNING;
+    if (!settling) {
+      exit_pid.timers_reset();
+      settling = true;
+    }
+    if (!swing) return exit_pid.exit_condition({chassis.left_motors[0], chassis.right_motors[0]});
+    return exit_pid.exit_condition(type == ez::LEFT_SWING ? chassis.left_motors[0] : chassis.right_motors[0]);
+  }
+
+  ez::e_mode mode_get() override { return swing ? ez::SWING : ez::TURN; }
+  double target_get() override { return new_target; }
+  double error_get() override { return exit_pid.error; }
+  double duration_predicted_get() override { return profile.duration(); }
+
+ private:
+  MotionProfile profile;
+  ez::PID exit_pid;
+  double new_target = 0.0;
+  uint64_t start_time = 0;
+  bool settling = false;
+};
+static Pool<ProfiledTurn> profiled_turns;
+
+static ProfiledTurn* profiled_turn_get(okapi::QAngle target, MotionProfile::constraints limits, ez::e_angle_behavior behavior) {
+  ProfiledTurn* out = profiled_turns.get();
+  out->swing = false;
+  out->target = target.convert(okapi::degree);
+  out->limits = limits;
+  out->behavior = behavior;
+  return out;
+}
+
+static ProfiledTurn* profiled_swing_get(ez::e_swing type, okapi::QAngle target, MotionProfile::constraints limits) {
+  ProfiledTurn* out = profiled_turns.get();
+  out->swing = true;
+  out->type = type;
+  out->target = target.convert(okapi::degree);
+  out->limits = limits;
+  return out;
+}
+
+void pid_profiled_turn_set(okapi::QAngle target, MotionProfile::constraints limits, ez::e_angle_behavior behavior) { start(profiled_turn_get(target, limits, behavior)); }
+
+void pid_profiled_turn_set(okapi::QAngle target, MotionProfile::constraints limits) { pid_profiled_turn_set(target, limits, chassis.pid_turn_behavior_get()); }
+
+void pid_profiled_turn_set(okapi::QAngle target) { pid_profiled_turn_set(target, turn_limits); }
+
+void pid_profiled_swing_set(ez::e_swing type, okapi::QAngle target, MotionProfile::constraints limits) { start(profiled_swing_get(type, target, limits)); }
+
+void pid_profiled_swing_set(ez::e_swing type, okapi::QAngle target) { pid_profiled_swing_set(type, target, swing_limits); }
+
+bool queue_profiled_turn(okapi::QAngle target, MotionProfile::constraints limits, ez::e_angle_behavior behavior) { return queue(profiled_turn_get(target, limits, behavior)); }
+
+bool queue_profiled_turn(okapi::QAngle target, MotionProfile::constraints limits) { return queue_profiled_turn(target, limits, chassis.pid_turn_behavior_get()); }
+
+bool queue_profiled_turn(okapi::QAngle target) { return queue_profiled_turn(target, turn_limits); }
+
+bool queue_profiled_swing(ez::e_swing type, okapi::QAngle target, MotionProfile::constraints limits) { return queue(profiled_swing_get(type, target, limits)); }
+
+bool queue_profiled_swing(ez::e_swing type, okapi::QAngle target) { return queue_profiled_swing(type, target, swing_limits); }
+}  // namespace motion
@@ -0,0 +1,201 @@
+#include "motion_profiler.hpp"
+
+#include "subsystems.hpp"
+
+namespace profiler {
+// Fixed storage so recording never allocates during an auton
+static const int MAX_MOTIONS = 128;
+static motion motions[MAX_MOTIONS];
+static int amount = 0;
+static bool open = false;
+static uint32_t auton_start = 0;
+
+void reset() {
+  amount = 0;
+  open = false;
+  auton_start = pros::millis();
+}
+
+int motions_amount() { return amount; }
+
+motion motion_get(int index) { return motions[index]; }
+
+// The PID that decides when the current motion exits
+static ez::PID* exit_pid(ez::e_mode mode) {
+  switch (mode) {
+    case ez::DRIVE:
+      return &chassis.leftPID;
+    case ez::TURN:
+    case ez::TURN_TO_POINT:
+      return &chassis.turnPID;
+    case ez::SWING:
+      return &chassis.swingPID;
+    case ez::POINT_TO_POINT:
+    case ez::PURE_PURSUIT:
+      return &chassis.xyPID;
+    default:
+      return nullptr;
+  }
+}
+
+static motion* begin(std::source_location loc) {
+  // A wait_until already started this motion
+  if (open) return &motions[amount - 1];
+  if (amount >= MAX_MOTIONS) return nullptr;
+
+  motion* m = &motions[amount++];
+  m->line = loc.line();
+  m->mode = chassis.drive_mode_get();
+  ez::PID* pid = exit_pid(m->mode);
+  m->target = pid != nullptr ? pid->target_get() : 0.0;
+  // leftPID targets an absolute sensor value, the motion was just set so the robot hasn't moved yet
+  if (m->mode == ez::DRIVE) m->target -= chassis.drive_sensor_left();
+  m->error = 0.0;
+  m->exit = ez::RUNNING;
+  m->exit_inferred = false;
+  m->chained = false;
+  m->start = pros::millis();
+  m->end = m->start;
+  m->predicted = 0;
+
+  // Motions in the motion task run with EZ-Template disabled
+  ::motion::Controller* controller = ::motion::current_get();
+  if (m->mode == ez::DISABLE && controller != nullptr) {
+    m->mode = controller->mode_get();
+    m->target = controller->target_get();
+    m->predicted = controller->duration_predicted_get() * 1000.0;
+  }
+  open = true;
+  return m;
+}
+
+static void finish(motion* m, bool chained) {
+  open = false;
+  if (m == nullptr) return;
+  m->end = pros::millis();
+  m->chained = chained;
+
+  ez::PID* pid = exit_pid(m->mode);
+  if (pid == nullptr) return;
+  m->error = m->mode == ez::DRIVE ? (chassis.leftPID.error + chassis.rightPID.error) / 2.0 : pid->error;
+
+  // pid_wait doesn't hand back the exit type, so this guesses from the error after it returned.
+  // The drive keeps moving after the exit, so a big exit that settled inside small_error reads as small
+  m->exit_inferred = true;
+  if (chassis.interfered)
+    m->exit = chassis.drive_current_left_over() || chassis.drive_current_right_over() ? ez::mA_EXIT : ez::VELOCITY_EXIT;
+  else
+    m->exit = fabs(m->error) <= pid->exit.small_error ? ez::SMALL_EXIT : ez::BIG_EXIT;
+}
+
+void wait(std::source_location loc) {
+  motion* m = begin(loc);
+  chassis.pid_wait();
+  finish(m, false);
+}
+
+void wait_quick_chain(std::source_location loc) {
+  motion* m = begin(loc);
+  chassis.pid_wait_quick_chain();
+  finish(m, true);
+}
+
+void motion_wait(std::source_location loc) {
+  motion* m = begin(loc);
+  ez::exit_output output = ::motion::wait();
+  open = false;
+  if (m == nullptr) return;
+  m->end = pros::millis();
+  ::motion::Controller* controller = ::motion::current_get();
+  m->error = controller != nullptr ? controller->error_get() : 0.0;
+  m->exit = output;
+}
+
+void wait_until(okapi::QLength target, std::source_location loc) {
+  begin(loc);
+  chassis.pid_wait_until(target);
+}
+
+void wait_until(okapi::QAngle target, std::source_location loc) {
+  begin(loc);
+  chassis.pid_wait_until(target);
+}
+
+void wait_until(double target, std::source_location loc) {
+  begin(loc);
+  chassis.pid_wait_until(target);
+}
+
+static const char* mode_to_string(ez::e_mode mode) {
+  switch (mode) {
+    case ez::SWING:
+      return "swing";
+    case ez::TURN:
+      return "turn";
+    case ez::TURN_TO_POINT:
+      return "turn pt";
+    case ez::DRIVE:
+      return "drive";
+    case ez::POINT_TO_POINT:
+      return "ptp";
+    case ez::PURE_PURSUIT:
+      return "pp";
+    default:
+      return "disable";
+  }
+}
+
+void report_print() {
+  uint32_t auton_time = pros::millis() - auton_start;
+
+  // Rank motions by how long they took, longest first
+  int order[MAX_MOTIONS];
+  uint32_t motion_time = 0;
+  uint32_t exit_time[ez::ERROR_NO_CONSTANTS + 1] = {0};
+  uint32_t chain_time = 0;
+  uint32_t profiled_time = 0, predicted_time = 0;
+  bool inferred = false;
+  for (int i = 0; i < amount; i++) {
+    order[i] = i;
+    uint32_t t = motions[i].end - motions[i].start;
+    motion_time += t;
+    if (motions[i].predicted != 0) {
+      profiled_time += t;
+      predicted_time += motions[i].predicted;
+    }
+    if (motions[i].chained)
+      chain_time += t;
+    else
+      exit_time[motions[i].exit] += t;
+    if (motions[i].exit_inferred && !motions[i].chained) inferred = true;
+  }
+  std::sort(order, order + amount, [](int a, int b) {
+    return motions[a].end - motions[a].start > motions[b].end - motions[b].start;
+  });
+
+  printf("\n---- Motion Profile ----\n");
+  printf("Auton took %.2fs, %.2fs in %i motions, %.2fs outside of motions\n",
+         auton_time / 1000.0, motion_time / 1000.0, amount, (auton_time - motion_time) / 1000.0);
+  printf("Small exit %.2fs, Big exit %.2fs, Velocity exit %.2fs, mA exit %.2fs, Chained %.2fs\n",
+         exit_time[ez::SMALL_EXIT] / 1000.0, exit_time[ez::BIG_EXIT] / 1000.0,
+         exit_time[ez::VELOCITY_EXIT] / 1000.0, exit_time[ez::mA_EXIT] / 1000.0, chain_time / 1000.0);
+  if (predicted_time != 0)
+    printf("Profiled motions took %.2fs, their profiles predicted %.2fs\n", profiled_time / 1000.0, predicted_time / 1000.0);
+  printf("  #  line  mode     target    error  exit            start   time   pred\n");
+  for (int i = 0; i < amount; i++) {
+    motion m = motions[order[i]];
+    std::string exit = m.chained ? "Chained" : ez::exit_to_string(m.exit) + (m.exit_inferred ? "*" : "");
+    printf("%3i  %4i  %-7s %7.2f  %7.2f  %-14s %6.2fs %5ims",
+           order[i] + 1, m.line, mode_to_string(m.mode), m.target, m.error, exit.c_str(),
+           (m.start - auton_start) / 1000.0, (int)(m.end - m.start));
+    if (m.predicted != 0)
+      printf(" %5ims\n", (int)m.predicted);
+    else
+      printf("      -\n");
+  }
+  if (inferred)
+    printf("* EZ-Template doesn't report why a motion exited, these are guessed from the error after it did\n");
+  if (amount >= MAX_MOTIONS)
+    printf("Only the first %i motions were recorded\n", MAX_MOTIONS);
+}
+}  // namespace profiler
@@ -0,0 +1,104 @@
+#include "odometry.hpp"
+
+#include "subsystems.hpp"
+
+namespace odometry {
+LoopStats stats("odometry", 5);
+
+static pros::Mutex lock;
+static bool running = false;
+static int period = 5;
+static ez::pose current = {0, 0, 0};
+
+// Sensor values the last loop integrated up to
+static double vertical_last = 0.0, horizontal_last = 0.0, imu_last = 0.0;
+static bool reset_pending = true;
+
+static e_integrator method = EXPONENTIAL;
+static bool interpolation = true;
+static HeadingInterpolator interpolator;
+
+void integrator_set(e_integrator input) { method = input; }
+e_integrator integrator_get() { return method; }
+
+void imu_interpolation_toggle(bool toggle) { interpolation = toggle; }
+bool imu_interpolation_enabled() { return interpolation; }
+
+void rate_set(int hz) {
+  period = std::clamp(1000 / std::clamp(hz, 1, 1000), 1, 1000);
+  stats.period_nominal_set(period);
+}
+int rate_get() { return 1000 / period; }
+
+// The tracking wheel perpendicular to the drive, if there is one
+static ez::tracking_wheel* horizontal_tracker() {
+  return chassis.odom_tracker_back != nullptr ? chassis.odom_tracker_back : chassis.odom_tracker_front;
+}
+
+static double vertical_get() { return (chassis.drive_sensor_left() + chassis.drive_sensor_right()) / 2.0; }
+
+static double horizontal_get() {
+  ez::tracking_wheel* tracker = horizontal_tracker();
+  return tracker != nullptr ? tracker->get() : 0.0;
+}
+
+// Moves the pose by what the sensors measured this loop
+static void update(double vertical, double horizontal, double heading) {
+  double dv = vertical - vertical_last;
+  double dh = horizontal - horizontal_last;
+  double dtheta = ez::util::to_rad(heading - imu_last);
+
+  // The horizontal wheel also rolls when the robot turns, by its distance to the center
+  ez::tracking_wheel* tracker = horizontal_tracker();
+  double offset = tracker == nullptr ? 0.0 : tracker == chassis.odom_tracker_back ? tracker->distance_to_center_get() : -tracker->distance_to_center_get();
+
+  current = integrate(method, current, dv, dh + offset * dtheta, heading - imu_last);
+}
+
+static void odometry_task() {
+  uint32_t now = pros::millis();
+  while (true) {
+    stats.iteration_start();
+
+    double vertical = vertical_get();
+    double horizontal = horizontal_get();
+    double heading = chassis.drive_imu_get();
+    if (interpolation) heading = interpolator.get(heading, -chassis.imu.get_gyro_rate().z * chassis.drive_imu_scaler_get(), pros::micros());
+    lock.take();
+    if (!reset_pending) update(vertical, horizontal, heading);
+    if (reset_pending) interpolator.reset();
+    reset_pending = false;
+    vertical_last = vertical;
+    horizontal_last = horizontal;
+    imu_last = heading;
+    lock.give();
+
+    stats.iteration_end();
+    pros::Task::delay_until(&now, period);
+  }
+}
+
+void initialize() {
+  current = chassis.odom_pose_get();
+  reset_pending = true;
+  running = true;
+  stats.period_nominal_set(period);
+  pros::Task task(odometry_task, TASK_PRIORITY_MAX, TASK_STACK_DEPTH_DEFAULT, "Odometry");
+}
+
+ez::pose pose_get() {
+  if (!running) return chassis.odom_pose_get();
+  lock.take();
+  ez::pose out = current;
+  lock.give();
+  return out;
+}
+
+void pose_set(ez::pose pose) {
+  chassis.odom_pose_set(pose);
+  lock.take();
+  current = pose;
+  reset_pending = true;
+  lock.give();
+}
+}  // namespace odometry
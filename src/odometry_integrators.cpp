@@ -0,0 +1,69 @@
+#include "odometry.hpp"
+
+namespace odometry {
+// Longest the heading is carried forward, past this the IMU has stopped updating
+static const uint64_t MAX_EXTRAPOLATION = 20000;
+
+static ez::pose euler(ez::pose pose, double forward, double right, double dtheta) {
+  double theta = ez::util::to_rad(pose.theta);
+  return {pose.x + right * cos(theta) + forward * sin(theta),
+          pose.y - right * sin(theta) + forward * cos(theta),
+          pose.theta + dtheta};
+}
+
+// Same math as EZ-Template's solve_xy_vert() and solve_xy_horiz()
+static ez::pose arc(ez::pose pose, double forward, double right, double dtheta) {
+  float turned = ez::util::to_rad(dtheta);
+  float chord = fabsf(turned) < 1e-6f ? 1.0f : 2.0f * sinf(turned / 2.0f) / turned;
+  float middle = (float)ez::util::to_rad(pose.theta) + turned / 2.0f;
+  float f = forward * chord, r = right * chord;
+  return {(float)pose.x + r * cosf(middle) + f * sinf(middle),
+          (float)pose.y - r * sinf(middle) + f * cosf(middle),
+          (float)pose.theta + (float)dtheta};
+}
+
+// Moves along the constant twist measured this loop, exact for any arc
+static ez::pose exponential(ez::pose pose, double forward, double right, double dtheta) {
+  double w = ez::util::to_rad(dtheta);
+
+  // sin(w)/w and (1 - cos(w))/w, with their series near 0 where those divide by nearly 0
+  double s, c;
+  if (fabs(w) < 1e-4) {
+    s = 1.0 - w * w / 6.0;
+    c = w / 2.0 - w * w * w / 24.0;
+  } else {
+    s = sin(w) / w;
+    c = (1.0 - cos(w)) / w;
+  }
+  double f = s * forward - c * right;
+  double r = c * forward + s * right;
+
+  double theta = ez::util::to_rad(pose.theta);
+  return {pose.x + r * cos(theta) + f * sin(theta),
+          pose.y - r * sin(theta) + f * cos(theta),
+          pose.theta + dtheta};
+}
+
+ez::pose integrate(e_integrator method, ez::pose pose, double forward, double right, double dtheta) {
+  switch (method) {
+    case EULER:
+      return euler(pose, forward, right, dtheta);
+    case ARC:
+      return arc(pose, forward, right, dtheta);
+    default:
+      return exponential(pose, forward, right, dtheta);
+  }
+}
+
+double HeadingInterpolator::get(double heading, double rate, uint64_t time) {
+  // A new sample came in sometime since the last loop
+  if (!valid || heading != last) {
+    last = heading;
+    sample_time = time;
+    valid = true;
+  }
+  return heading + rate * std::min(time - sample_time, MAX_EXTRAPOLATION) / 1000000.0;
+}
+
+void HeadingInterpolator::reset() { valid = false; }
+}  // namespace odometry
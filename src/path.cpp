@@ -0,0 +1,173 @@
+#include "path.hpp"
+
+#include <cmath>
+
+#include "path_math.hpp"
+
+Path::Path(std::span<point> storage, int amount) : storage(storage), points(storage.data()), size(amount) {}
+
+void Path::clear() {
+  if (!read_only) size = 0;
+}
+
+int Path::amount() const { return size; }
+
+int Path::capacity() const { return storage.size(); }
+
+bool Path::read_only_get() const { return read_only; }
+
+const Path::point& Path::operator[](int index) const { return points[index]; }
+
+bool Path::point_add(double x, double y, const ez::odom& target, int index) {
+  if (size >= (int)storage.size()) return false;
+  storage[size++] = path_math::point_get(x, y, target, index);
+  return true;
+}
+
+bool Path::build(ez::pose start, std::span<const ez::odom> input, double spacing) {
+  if (read_only) return false;
+  size = 0;
+  if (!path_math::inject(start.x, start.y, input, spacing, [&](double x, double y, int i) { return point_add(x, y, input[i], i); })) {
+    size = 0;
+    return false;
+  }
+  path_math::curvature_calculate(storage.first(size));
+  return true;
+}
+
+bool Path::build(std::span<const ez::odom> input, double spacing) {
+  // Starting on the first input point makes its segment zero long, so it's skipped
+  if (input.empty()) return build(ez::pose{0, 0, 0}, input, spacing);
+  return build(input[0].target, input, spacing);
+}
+
+bool Path::build(std::initializer_list<ez::odom> input, double spacing) {
+  return build(std::span<const ez::odom>(input.begin(), input.size()), spacing);
+}
+
+void Path::smooth(double weight_smooth, double weight_data, double tolerance, int max_iterations) {
+  if (read_only) return;
+  path_math::smooth(storage.first(size), weight_smooth, weight_data, tolerance, max_iterations);
+  path_math::curvature_calculate(storage.first(size));
+}
+
+///
+// Splines
+///
+// Solves for the second derivative at each knot of a natural cubic spline with the Thomas algorithm
+static void spline_solve(const double* h, const double* y, int n, double* m) {
+  double c[Path::MAX_SPLINE_POINTS], d[Path::MAX_SPLINE_POINTS];
+  m[0] = m[n - 1] = 0.0;
+  if (n < 3) {
+    for (int i = 0; i < n; i++) m[i] = 0.0;
+    return;
+  }
+
+  // Forward sweep over the interior knots
+  for (int i = 1; i < n - 1; i++) {
+    double lower = h[i - 1], diag = 2.0 * (h[i - 1] + h[i]), upper = h[i];
+    double rhs = 6.0 * ((y[i + 1] - y[i]) / h[i] - (y[i] - y[i - 1]) / h[i - 1]);
+    if (i > 1) {
+      diag -= lower * c[i - 1];
+      rhs -= lower * d[i - 1];
+    }
+    c[i] = upper / diag;
+    d[i] = rhs / diag;
+  }
+
+  // Back substitution
+  m[n - 2] = d[n - 2];
+  for (int i = n - 3; i >= 1; i--) m[i] = d[i] - c[i] * m[i + 1];
+}
+
+// Value, first and second derivative of one cubic piece at s along a piece h long
+static void spline_eval(double y0, double y1, double m0, double m1, double h, double s, double* value, double* d1, double* d2) {
+  double r = h - s;
+  double a = y0 / h - m0 * h / 6.0;
+  double b = y1 / h - m1 * h / 6.0;
+  *value = m0 * r * r * r / (6.0 * h) + m1 * s * s * s / (6.0 * h) + a * r + b * s;
+  *d1 = -m0 * r * r / (2.0 * h) + m1 * s * s / (2.0 * h) - a + b;
+  *d2 = m0 * r / h + m1 * s / h;
+}
+
+bool Path::spline_run(const double* x, const double* y, const int* knot_input, std::span<const ez::odom> input, int first, int last, double spacing) {
+  int n = last - first + 1;
+  double h[MAX_SPLINE_POINTS] = {}, mx[MAX_SPLINE_POINTS], my[MAX_SPLINE_POINTS];
+  for (int i = 0; i < n - 1; i++) h[i] = hypot(x[first + i + 1] - x[first + i], y[first + i + 1] - y[first + i]);
+  spline_solve(h, x + first, n, mx);
+  spline_solve(h, y + first, n, my);
+
+  // Walk each piece in small steps and drop a point every spacing of arc length
+  double travelled = spacing;
+  double px = x[first], py = y[first];
+  for (int i = 0; i < n - 1; i++) {
+    const ez::odom& target = input[knot_input[first + i + 1]];
+    int steps = spacing > 0.0 ? std::max(1, (int)ceil(h[i] / spacing * 8.0)) : 1;
+    for (int j = 0; j < steps; j++) {
+      double s = h[i] * j / steps;
+      double sx, dx, ddx, sy, dy, ddy;
+      spline_eval(x[first + i], x[first + i + 1], mx[i], mx[i + 1], h[i], s, &sx, &dx, &ddx);
+      spline_eval(y[first + i], y[first + i + 1], my[i], my[i + 1], h[i], s, &sy, &dy, &ddy);
+      travelled += hypot(sx - px, sy - py);
+      px = sx;
+      py = sy;
+      if (travelled < spacing) continue;
+
+      travelled = 0.0;
+      if (!point_add(sx, sy, target, knot_input[first + i + 1])) return false;
+      double speed = hypot(dx, dy);
+      storage[size - 1].curvature = speed > 1e-12 ? -(dx * ddy - dy * ddx) / (speed * speed * speed) : 0.0;
+    }
+  }
+  return true;
+}
+
+bool Path::build_spline(ez::pose start, std::span<const ez::odom> input, double spacing) {
+  if (read_only) return false;
+  size = 0;
+  if (input.empty()) return true;
+  if ((int)input.size() + 1 > MAX_SPLINE_POINTS) return false;
+
+  // Knots are the start and every input point, repeats would make a piece 0 long
+  double x[MAX_SPLINE_POINTS], y[MAX_SPLINE_POINTS];
+  int knot_input[MAX_SPLINE_POINTS];
+  int n = 0;
+  x[n] = start.x;
+  y[n] = start.y;
+  knot_input[n++] = 0;
+  for (int i = 0; i < (int)input.size(); i++) {
+    if (hypot(input[i].target.x - x[n - 1], input[i].target.y - y[n - 1]) < 1e-9) continue;
+    x[n] = input[i].target.x;
+    y[n] = input[i].target.y;
+    knot_input[n++] = i;
+  }
+
+  // Each run of pieces going the same direction is its own spline
+  int first = 0;
+  for (int k = 1; k < n; k++) {
+    bool run_end = k == n - 1 || input[knot_input[k + 1]].drive_direction != input[knot_input[k]].drive_direction;
+    if (!run_end) continue;
+    if (!spline_run(x, y, knot_input, input, first, k, spacing)) {
+      size = 0;
+      return false;
+    }
+    first = k;
+  }
+
+  // The last point goes exactly on the last input point
+  if (!point_add(x[n - 1], y[n - 1], input.back(), input.size() - 1)) {
+    size = 0;
+    return false;
+  }
+  if (size > 1) storage[size - 1].curvature = storage[size - 2].curvature;
+  return true;
+}
+
+bool Path::build_spline(std::span<const ez::odom> input, double spacing) {
+  if (input.empty()) return build_spline(ez::pose{0, 0, 0}, input, spacing);
+  return build_spline(input[0].target, input, spacing);
+}
+
+bool Path::build_spline(std::initializer_list<ez::odom> input, double spacing) {
+  return build_spline(std::span<const ez::odom>(input.begin(), input.size()), spacing);
+}
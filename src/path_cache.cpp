@@ -0,0 +1,79 @@
+#include "path_cache.hpp"
+
+#include "motion.hpp"
+#include "subsystems.hpp"
+
+namespace paths {
+struct entry {
+  bool registered = false;
+  bool built = false;
+  bool smooth = true;
+  int input_start = 0;
+  int input_amount = 0;
+  Path path{std::span<Path::point>()};
+};
+
+static entry entries[MAX_PATHS];
+static ez::odom inputs[MAX_INPUT_POINTS];
+static int inputs_used = 0;
+static Path::point points[MAX_POINTS];
+static int points_used = 0;
+
+bool add(int id, std::initializer_list<ez::odom> input, bool smooth) {
+  if (id < 0 || id >= MAX_PATHS) return false;
+  if (inputs_used + (int)input.size() > MAX_INPUT_POINTS) return false;
+
+  entry& e = entries[id];
+  e.registered = true;
+  e.built = false;
+  e.smooth = smooth;
+  e.input_start = inputs_used;
+  e.input_amount = input.size();
+  for (const ez::odom& o : input) inputs[inputs_used++] = o;
+  return true;
+}
+
+void invalidate() {
+  for (entry& e : entries) e.built = false;
+  points_used = 0;
+}
+
+bool build() {
+  double spacing = chassis.odom_path_spacing_get();
+  bool fit = true;
+  for (entry& e : entries) {
+    if (!e.registered || e.built) continue;
+
+    // Each path gets whatever is left, then gives back what it didn't use
+    e.path = Path(std::span<Path::point>(points + points_used, MAX_POINTS - points_used));
+    if (!e.path.build(std::span<const ez::odom>(inputs + e.input_start, e.input_amount), spacing)) {
+      fit = false;
+      continue;
+    }
+    if (e.smooth) motion::path_smooth(e.path);
+    e.path = Path(std::span<Path::point>(points + points_used, e.path.amount()), e.path.amount());
+    points_used += e.path.amount();
+    e.built = true;
+  }
+  return fit;
+}
+
+Path* get(int id) {
+  if (id < 0 || id >= MAX_PATHS || !entries[id].built) return nullptr;
+  return &entries[id].path;
+}
+
+void print() {
+  printf("\n---- Path Cache ----\n");
+  for (int i = 0; i < MAX_PATHS; i++) {
+    entry& e = entries[i];
+    if (!e.registered) continue;
+    printf("%3i  %3i input points  ", i, e.input_amount);
+    if (e.built)
+      printf("%4i points%s\n", e.path.amount(), e.smooth ? ", smoothed" : "");
+    else
+      printf("not built\n");
+  }
+  printf("%i/%i input points, %i/%i points used\n", inputs_used, MAX_INPUT_POINTS, points_used, MAX_POINTS);
+}
+}  // namespace paths
@@ -0,0 +1,156 @@
+#include "sysid.hpp"
+
+#include <cmath>
+
+#include "EZ-Template/util.hpp"
+
+namespace sysid {
+// Fixed storage, 20s of samples at 10ms
+static const int MAX_SAMPLES = 2000;
+static const int PERIOD = 10;
+static sample logged[MAX_SAMPLES];
+static int amount = 0;
+static int test = 0;
+
+void log_clear() {
+  amount = 0;
+  test = 0;
+}
+
+int samples_amount() { return amount; }
+
+sample sample_get(int index) { return logged[index]; }
+
+static void sample_add(mechanism& m, double output) {
+  if (amount >= MAX_SAMPLES) return;
+  logged[amount++] = {pros::millis(), test, output, m.voltage_get(), m.position_get(), m.current_get()};
+}
+
+// Runs output(t) for a while, logging every period, then lets the mechanism stop
+static void test_run(mechanism& m, int time, int rest, std::function<double(double)> output) {
+  uint32_t start = pros::millis();
+  uint32_t now = start;
+  while (now - start < (uint32_t)time) {
+    double out = ez::util::clamp(output((now - start) / 1000.0), 127);
+    m.output_set(out);
+    sample_add(m, out);
+    pros::Task::delay_until(&now, PERIOD);
+  }
+  m.output_set(0);
+  test++;
+  pros::delay(rest);
+}
+
+void quasistatic(mechanism& m, double rate, int time) {
+  test_run(m, time, 0, [rate](double t) { return rate * t; });
+}
+
+void dynamic(mechanism& m, double output, int time) {
+  test_run(m, time, 0, [output](double) { return output; });
+}
+
+///
+// Fitting
+///
+// Central differences over a few samples, noisy encoders make single steps useless
+static const int SPAN = 2;
+
+static bool same_test(const sample* samples, int amount, int a, int b) {
+  return a >= 0 && b < amount && samples[a].test == samples[b].test;
+}
+
+static double velocity_at(const sample* samples, int i) {
+  const sample& a = samples[i - SPAN];
+  const sample& b = samples[i + SPAN];
+  return (b.position - a.position) / ((b.time - a.time) / 1000.0);
+}
+
+// Solves a 3x3 system in place with gaussian elimination
+static bool solve(double m[3][4]) {
+  for (int col = 0; col < 3; col++) {
+    int pivot = col;
+    for (int row = col + 1; row < 3; row++)
+      if (fabs(m[row][col]) > fabs(m[pivot][col])) pivot = row;
+    if (fabs(m[pivot][col]) < 1e-12) return false;
+    for (int k = 0; k < 4; k++) std::swap(m[col][k], m[pivot][k]);
+    for (int row = 0; row < 3; row++) {
+      if (row == col) continue;
+      double f = m[row][col] / m[col][col];
+      for (int k = 0; k < 4; k++) m[row][k] -= f * m[col][k];
+    }
+  }
+  for (int row = 0; row < 3; row++) m[row][3] /= m[row][row];
+  return true;
+}
+
+result fit(const sample* samples, int amount, double min_velocity) {
+  // Normal equations for output = kS * sgn(v) + kV * v + kA * a
+  double m[3][4] = {{0}};
+  double sum_y = 0.0, sum_yy = 0.0;
+  int used = 0;
+  for (int i = 2 * SPAN; i < amount - 2 * SPAN; i++) {
+    if (!same_test(samples, amount, i - 2 * SPAN, i + 2 * SPAN)) continue;
+    double v = velocity_at(samples, i);
+    if (fabs(v) < min_velocity) continue;
+    double a = (velocity_at(samples, i + SPAN) - velocity_at(samples, i - SPAN)) / ((samples[i + SPAN].time - samples[i - SPAN].time) / 1000.0);
+
+    double x[3] = {(double)ez::util::sgn(v), v, a};
+    double y = samples[i].output;
+    for (int r = 0; r < 3; r++) {
+      for (int c = 0; c < 3; c++) m[r][c] += x[r] * x[c];
+      m[r][3] += x[r] * y;
+    }
+    sum_y += y;
+    sum_yy += y * y;
+    used++;
+  }
+
+  result out = {0.0, 0.0, 0.0, 0.0, used};
+  if (used < 3) return out;
+  double y_x[3] = {m[0][3], m[1][3], m[2][3]};
+  if (!solve(m)) return out;
+  out.kS = m[0][3];
+  out.kV = m[1][3];
+  out.kA = m[2][3];
+
+  // Residual sum of squares from the normal equations, y'y - b'X'y
+  double ss_res = sum_yy - (out.kS * y_x[0] + out.kV * y_x[1] + out.kA * y_x[2]);
+  double ss_tot = sum_yy - sum_y * sum_y / used;
+  out.r2 = ss_tot > 0.0 ? 1.0 - ss_res / ss_tot : 0.0;
+  return out;
+}
+
+///
+// Running
+///
+bool log_save(const char* name) {
+  if (!pros::usd::is_installed()) return false;
+  char path[64];
+  snprintf(path, sizeof(path), "/usd/sysid_%s.csv", name);
+  FILE* file = fopen(path, "w");
+  if (file == nullptr) return false;
+  fprintf(file, "time,test,output,voltage,position,current\n");
+  for (int i = 0; i < amount; i++)
+    fprintf(file, "%u,%i,%.2f,%.3f,%.4f,%.0f\n", (unsigned)logged[i].time, logged[i].test, logged[i].output, logged[i].voltage, logged[i].position, logged[i].current);
+  fclose(file);
+  return true;
+}
+
+result characterize(mechanism& m, settings s) {
+  log_clear();
+  test_run(m, s.ramp_time, s.rest_time, [&](double t) { return s.ramp_rate * t; });
+  test_run(m, s.ramp_time, s.rest_time, [&](double t) { return -s.ramp_rate * t; });
+  test_run(m, s.step_time, s.rest_time, [&](double) { return s.step_output; });
+  test_run(m, s.step_time, s.rest_time, [&](double) { return -s.step_output; });
+
+  if (!log_save(m.name))
+    printf("No SD card, %s log wasn't saved\n", m.name);
+  result r = fit(logged, amount, m.min_velocity);
+  result_print(m.name, r);
+  return r;
+}
+
+void result_print(const char* name, result r) {
+  printf("%-8s kS %6.3f  kV %7.4f  kA %7.4f  r2 %.3f  (%i samples)\n", name, r.kS, r.kV, r.kA, r.r2, r.samples);
+}
+}  // namespace sysid
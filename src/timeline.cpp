@@ -0,0 +1,117 @@
+#include "timeline.hpp"
+
+#include "motion.hpp"
+#include "subsystems.hpp"
+
+namespace timeline {
+struct action {
+  e_trigger trigger;
+  double value;
+  void (*run)();
+  bool armed;
+  uint32_t start_time;
+  double start_left, start_right;
+  int heading_side;  // which side of the target heading the robot started on
+};
+
+static pros::Mutex lock;
+static action actions[MAX_ACTIONS];
+static int amount = 0;
+
+static bool add(e_trigger trigger, double value, void (*run)()) {
+  lock.take();
+  bool added = amount < MAX_ACTIONS;
+  if (added) actions[amount++] = {trigger, value, run, false, 0, 0.0, 0.0, 0};
+  lock.give();
+  return added;
+}
+
+bool at_distance(okapi::QLength distance, void (*action)()) { return add(DISTANCE, fabs(distance.convert(okapi::inch)), action); }
+bool at_index(int index, void (*action)()) { return add(PATH_INDEX, index, action); }
+bool at_time(okapi::QTime time, void (*action)()) { return add(TIME, time.convert(okapi::millisecond), action); }
+bool at_heading(okapi::QAngle heading, void (*action)()) { return add(HEADING, heading.convert(okapi::degree), action); }
+
+void motion_start() {
+  uint32_t now = pros::millis();
+  double left = chassis.drive_sensor_left();
+  double right = chassis.drive_sensor_right();
+  double heading = chassis.drive_imu_get();
+
+  lock.take();
+  for (int i = 0; i < amount; i++) {
+    action& a = actions[i];
+    if (a.armed) continue;
+    a.armed = true;
+    a.start_time = now;
+    a.start_left = left;
+    a.start_right = right;
+    a.heading_side = ez::util::sgn(a.value - heading);
+  }
+  lock.give();
+}
+
+void clear() {
+  lock.take();
+  amount = 0;
+  lock.give();
+}
+
+int pending_amount() { return amount; }
+
+void wait(int timeout) {
+  uint32_t start = pros::millis();
+  while (amount > 0 && pros::millis() - start < (uint32_t)timeout)
+    pros::delay(ez::util::DELAY_TIME);
+}
+
+///
+// Task
+///
+static bool triggered(const action& a, uint32_t now, double left, double right, double heading, int index) {
+  switch (a.trigger) {
+    case DISTANCE:
+      return fabs((left - a.start_left) + (right - a.start_right)) / 2.0 >= a.value;
+    case PATH_INDEX:
+      return index >= a.value;
+    case TIME:
+      return now - a.start_time >= a.value;
+    case HEADING:
+      return ez::util::sgn(a.value - heading) != a.heading_side;
+    default:
+      return false;
+  }
+}
+
+static void timeline_task() {
+  uint32_t now = pros::millis();
+  void (*ready[MAX_ACTIONS])();
+  while (true) {
+    double left = chassis.drive_sensor_left();
+    double right = chassis.drive_sensor_right();
+    double heading = chassis.drive_imu_get();
+    int index = motion::path_index_get();
+
+    // Pull out everything that's ready, in the order it was scheduled
+    int ready_amount = 0;
+    lock.take();
+    int kept = 0;
+    for (int i = 0; i < amount; i++) {
+      if (actions[i].armed && triggered(actions[i], now, left, right, heading, index))
+        ready[ready_amount++] = actions[i].run;
+      else
+        actions[kept++] = actions[i];
+    }
+    amount = kept;
+    lock.give();
+
+    // Run outside the lock so actions can schedule more actions
+    for (int i = 0; i < ready_amount; i++) ready[i]();
+
+    pros::Task::delay_until(&now, ez::util::DELAY_TIME);
+  }
+}
+
+void initialize() {
+  pros::Task task(timeline_task, TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, "Timeline");
+}
+}  // namespace timeline
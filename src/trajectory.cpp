@@ -0,0 +1,90 @@
+#include "trajectory.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+static const double METERS_PER_INCH = 0.0254;
+
+Trajectory::Trajectory(std::span<point> storage, int amount) : storage(storage), points(storage.first(amount)) {}
+
+Trajectory::Trajectory(std::span<const point> points) : points(points) {}
+
+void Trajectory::clear() { points = storage.first(0); }
+
+int Trajectory::amount() const { return points.size(); }
+
+int Trajectory::capacity() const { return storage.size(); }
+
+const Trajectory::point& Trajectory::operator[](int index) const { return points[index]; }
+
+double Trajectory::duration() const { return points.empty() ? 0.0 : points.back().time - points.front().time; }
+
+bool Trajectory::build(std::span<const squiggles::ProfilePoint> input) {
+  clear();
+  if (input.size() > storage.size()) return false;
+
+  for (size_t i = 0; i < input.size(); i++) {
+    const squiggles::ControlVector& v = input[i].vector;
+    storage[i] = {input[i].time,
+                  v.pose.x / METERS_PER_INCH,
+                  v.pose.y / METERS_PER_INCH,
+                  ez::util::wrap_angle(90.0 - ez::util::to_deg(v.pose.yaw)),
+                  v.vel / METERS_PER_INCH,
+                  v.accel / METERS_PER_INCH,
+                  -input[i].curvature * METERS_PER_INCH};
+  }
+  points = storage.first(input.size());
+  return true;
+}
+
+bool Trajectory::load(const char* path) {
+  clear();
+  if (!pros::usd::is_installed()) return false;
+  FILE* file = fopen(path, "rb");
+  if (file == nullptr) return false;
+
+  // Points are read straight into the storage, nothing is parsed
+  file_header header;
+  bool ok = fread(&header, sizeof(header), 1, file) == 1 &&
+            memcmp(header.magic, "EZTJ", 4) == 0 &&
+            header.version == FILE_VERSION &&
+            header.point_size == sizeof(point) &&
+            header.amount <= storage.size() &&
+            fread(storage.data(), sizeof(point), header.amount, file) == header.amount;
+  fclose(file);
+  if (ok) points = storage.first(header.amount);
+  return ok;
+}
+
+bool Trajectory::save(const char* path) const {
+  FILE* file = fopen(path, "wb");
+  if (file == nullptr) return false;
+  file_header header = {{'E', 'Z', 'T', 'J'}, FILE_VERSION, sizeof(point), (uint32_t)points.size(), 0};
+  bool ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+            fwrite(points.data(), sizeof(point), points.size(), file) == points.size();
+  return fclose(file) == 0 && ok;
+}
+
+int Trajectory::index_get(double time) const {
+  if (points.empty()) return -1;
+  auto after = std::upper_bound(points.begin(), points.end(), time, [](double t, const point& p) { return t < p.time; });
+  return std::max(0, (int)(after - points.begin()) - 1);
+}
+
+Trajectory::point Trajectory::sample(double time) const {
+  if (points.empty()) return {0, 0, 0, 0, 0, 0, 0};
+  int i = index_get(time);
+  if (i >= (int)points.size() - 1 || time <= points[i].time) return points[i];
+
+  const point& a = points[i];
+  const point& b = points[i + 1];
+  double t = (time - a.time) / (b.time - a.time);
+  return {time,
+          a.x + (b.x - a.x) * t,
+          a.y + (b.y - a.y) * t,
+          a.theta + ez::util::wrap_angle(b.theta - a.theta) * t,
+          a.velocity + (b.velocity - a.velocity) * t,
+          a.acceleration + (b.acceleration - a.acceleration) * t,
+          a.curvature + (b.curvature - a.curvature) * t};
+}
@@ -0,0 +1,156 @@
+// Runs routines from autons.cpp on DriveSim, on the host.
+//
+// From the project root:
+//   make -C tools auton_sim
+//   ./tools/bin/auton_sim                     lists the routines
+//   ./tools/bin/auton_sim MatchAutonAWP [s]   runs one, with an optional time limit
+//
+// The routine runs unchanged, against the chassis in host/chassis.cpp and the
+// devices in host/devices.cpp, with the same setup initialize() and
+// autonomous() do.  The drive motors and IMU are wired to DriveSim, and
+// everything else just records what it was told.  Simulated time only moves
+// while every task is waiting, so a 15s auton takes a fraction of a second
+// and two runs always match.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "drive_sim.hpp"
+#include "host.hpp"
+#include "main.h"
+
+// Routines that only use what the chassis shim implements
+struct routine {
+  const char* name;
+  void (*run)();
+};
+
+static const routine ROUTINES[] = {
+    {"MatchAutonAWP", MatchAutonAWP},
+    {"QualAutonR", QualAutonR},
+    {"QualAutonL", QualAutonL},
+    {"SkillsAutonPark", SkillsAutonPark},
+    {"SkillsAuton1", SkillsAuton1},
+    {"SkillsAuton2", SkillsAuton2},
+    {"MatchAutonR", MatchAutonR},
+    {"MatchAutonL", MatchAutonL},
+    {"drive_example", drive_example},
+    {"turn_example", turn_example},
+    {"drive_and_turn", drive_and_turn},
+    {"odom_pp_buffer_example", odom_pp_buffer_example},
+};
+
+static const int IMU_PERIOD = 10;  // ms, the IMU's default data rate
+
+static DriveSim sim;
+
+// Average physical output of one side, motors on reversed ports turn the other way
+static double side_output(std::vector<pros::Motor>& motors) {
+  double sum = 0.0;
+  for (auto& motor : motors) sum += host::port_get(motor.get_port()).output * (motor.get_port() < 0 ? -1.0 : 1.0);
+  return sum / motors.size();
+}
+
+static void side_write(std::vector<pros::Motor>& motors, double position, double velocity, double current) {
+  // Wheel inches to revolutions of the cartridge output
+  double revolutions_per_inch = (sim.constants.motor_rpm / sim.constants.wheel_rpm) / (sim.constants.wheel_diameter * M_PI);
+  for (auto& motor : motors) {
+    host::port& p = host::port_get(motor.get_port());
+    double direction = motor.get_port() < 0 ? -1.0 : 1.0;
+    p.position = position * revolutions_per_inch * direction;
+    p.velocity = velocity * revolutions_per_inch * 60.0 * direction;
+    p.current = current;
+  }
+}
+
+// Runs inside the scheduler every simulated ms
+static void tick() {
+  sim.drive_set(side_output(chassis.left_motors), side_output(chassis.right_motors));
+  sim.step(0.001);
+
+  DriveSim::State state = sim.state();
+  side_write(chassis.left_motors, state.left_position, state.left_velocity, state.left_current);
+  side_write(chassis.right_motors, state.right_position, state.right_velocity, state.right_current);
+
+  if ((host::time_get() / 1000) % IMU_PERIOD == 0) {
+    host::port& imu = host::port_get(chassis.imu.get_port());
+    imu.heading = state.imu_heading;
+    imu.rate = state.imu_rate;
+  }
+}
+
+static void usage() {
+  printf("usage: auton_sim <routine> [time limit in s]\n\nroutines:\n");
+  for (auto& r : ROUTINES) printf("  %s\n", r.name);
+}
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    usage();
+    return 1;
+  }
+  const routine* selected = nullptr;
+  for (auto& r : ROUTINES)
+    if (strcmp(argv[1], r.name) == 0) selected = &r;
+  if (selected == nullptr) {
+    printf("unknown routine %s\n\n", argv[1]);
+    usage();
+    return 1;
+  }
+  double limit = argc > 2 ? atof(argv[2]) : 60.0;
+
+  // The drive runs the cartridges the wheel rpm is geared from
+  pros::motor_gearset_e_t gearing = sim.constants.motor_rpm >= 600.0 ? pros::E_MOTOR_GEAR_BLUE : sim.constants.motor_rpm >= 200.0 ? pros::E_MOTOR_GEAR_GREEN : pros::E_MOTOR_GEAR_RED;
+  for (auto& motor : chassis.left_motors) motor.set_gearing(gearing);
+  for (auto& motor : chassis.right_motors) motor.set_gearing(gearing);
+  host::tick_set(tick);
+
+  // Stops routines that never finish, like a match ending
+  pros::Task watchdog([limit] {
+    pros::delay(limit * 1000.0);
+    printf("\nauton_sim: stopped at the %.1fs time limit\n", limit);
+    fflush(stdout);
+    std::_Exit(1);
+  });
+
+  // What initialize() does that applies to the drive
+  default_constants();
+  paths_register();
+  paths::build();
+  chassis.initialize();
+  battery::initialize();
+  motion::rate_set(200);
+  motion::initialize();
+  odometry::rate_set(200);
+  odometry::initialize();
+  timeline::initialize();
+
+  // And what autonomous() does around the selected routine
+  chassis.pid_targets_reset();
+  chassis.drive_imu_reset();
+  chassis.drive_sensor_reset();
+  odometry::pose_set({0, 0, 0});
+  chassis.drive_brake_set(pros::E_MOTOR_BRAKE_COAST);
+  profiler::reset();
+  LoopStats::all_reset();
+  timeline::clear();
+
+  auto wall_start = std::chrono::steady_clock::now();
+  uint64_t sim_start = host::time_get();
+  selected->run();
+  double sim_time = (host::time_get() - sim_start) / 1e6;
+  double wall_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count();
+
+  profiler::report_print();
+  LoopStats::all_print();
+
+  DriveSim::State state = sim.state();
+  ez::pose odom = odometry::pose_get();
+  printf("\n%s finished in %.2fs of simulated time (%.3fs wall, %.0fx)\n", selected->name, sim_time, wall_time, sim_time / wall_time);
+  printf("true pose  x %7.2f  y %7.2f  theta %7.2f\n", state.pose.x, state.pose.y, state.pose.theta);
+  printf("odom pose  x %7.2f  y %7.2f  theta %7.2f\n", odom.x, odom.y, odom.theta);
+  fflush(stdout);
+  std::_Exit(0);  // The drive and odometry tasks never return
+}
@@ -0,0 +1,22 @@
+// Runs the benchmark suite from src/benchmark.cpp on the host.
+//
+// From the project root:
+//   make -C tools bench
+//   ./tools/bin/bench
+//
+// The same kernels the brain runs from bench::auton(), timed with the wall
+// clock instead of pros::micros(), see host/prelude.h.  EZ-Template's own
+// functions are the host versions in host/chassis.cpp here, so the numbers
+// for those are for comparing changes on the host, the brain's are the ones
+// that count.
+
+#include <cstdio>
+#include <cstdlib>
+
+#include "main.h"
+
+int main() {
+  bench::auton();
+  fflush(stdout);
+  std::_Exit(0);  // The chassis' auto task never ends
+}
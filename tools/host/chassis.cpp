@@ -0,0 +1,673 @@
+// Host version of the parts of EZ-Template's Drive that autons.cpp leans on.
+//
+// EZ-Template only ships as a prebuilt library for the brain, so this
+// reimplements the drive, turn and exit logic the way EZ-Template 3 runs it:
+// the same PID and slew math, the same 10ms auto task and the same exit
+// timers.  Odom motions, swings and opcontrol aren't here, only the path
+// processing, odom math and joystick curve tools/bench times.  Anything that
+// isn't used by a routine the simulator runs is left out, the host build
+// links with --gc-sections so they're never needed.
+
+#include "EZ-Template/api.hpp"
+#include "main.h"
+
+using namespace ez;
+
+// The same robot main.cpp builds
+ez::Drive chassis(
+    {-14, 15, -16},  // Left Chassis Ports (negative port will reverse it!)
+    {11, -12, 13},   // Right Chassis Ports (negative port will reverse it!)
+    5,               // IMU Port
+    3.25,            // Wheel Diameter
+    360);            // Wheel RPM
+
+namespace ez {
+///
+// PID
+///
+PID::PID() {}
+
+PID::PID(double p, double i, double d, double start_i, std::string name) {
+  constants_set(p, i, d, start_i);
+  name_set(name);
+}
+
+void PID::name_set(std::string p_name) {
+  name = p_name;
+  name_active = !name.empty();
+}
+
+void PID::constants_set(double p, double i, double d, double p_start_i) { constants = {p, i, d, p_start_i}; }
+
+PID::Constants PID::constants_get() { return constants; }
+
+void PID::exit_condition_set(int p_small_exit_time, double p_small_error, int p_big_exit_time, double p_big_error, int p_velocity_exit_time, int p_mA_timeout) {
+  exit = {p_small_exit_time, p_small_error, p_big_exit_time, p_big_error, p_velocity_exit_time, p_mA_timeout};
+}
+
+void PID::target_set(double input) { target = input; }
+
+double PID::target_get() { return target; }
+
+void PID::i_reset_toggle(bool toggle) { reset_i_sgn = toggle; }
+
+bool PID::i_reset_get() { return reset_i_sgn; }
+
+void PID::velocity_sensor_main_exit_set(double zero) { velocity_zero_main = zero; }
+
+double PID::velocity_sensor_main_exit_get() { return velocity_zero_main; }
+
+void PID::velocity_sensor_secondary_exit_set(double zero) { velocity_zero_secondary = zero; }
+
+double PID::velocity_sensor_secondary_exit_get() { return velocity_zero_secondary; }
+
+void PID::variables_reset() {
+  output = 0.0;
+  target = 0.0;
+  error = 0.0;
+  prev_error = 0.0;
+  integral = 0.0;
+  time = 0;
+  prev_time = 0;
+}
+
+void PID::timers_reset() { i = j = k = l = m = 0; }
+
+double PID::compute(double current) { return compute_error(target - current, current); }
+
+double PID::compute_error(double err, double current) {
+  error = err;
+  cur = current;
+  return raw_compute();
+}
+
+// Derivative is on the measurement, and I only builds up close to the target
+double PID::raw_compute() {
+  derivative = cur - prev_current;
+
+  if (constants.ki != 0.0) {
+    if (fabs(error) < constants.start_i) integral += error;
+    if (util::sgn(error) != util::sgn(prev_error) && reset_i_sgn) integral = 0.0;
+  }
+
+  output = (error * constants.kp) + (integral * constants.ki) - (derivative * constants.kd);
+
+  prev_current = cur;
+  prev_error = error;
+  return output;
+}
+
+// Each timer is stepped once per call, callers call this every util::DELAY_TIME
+exit_output PID::exit_condition(bool print) {
+  if (exit.small_error == 0 && exit.small_exit_time == 0 && exit.big_error == 0 && exit.big_exit_time == 0 && exit.velocity_exit_time == 0 && exit.mA_timeout == 0)
+    return ERROR_NO_CONSTANTS;
+
+  if (exit.small_error != 0) {
+    if (fabs(error) < exit.small_error) {
+      j += util::DELAY_TIME;
+      i = 0;  // The big timer doesn't run while the small one does
+      if (j > exit.small_exit_time) {
+        timers_reset();
+        return SMALL_EXIT;
+      }
+    } else {
+      j = 0;
+    }
+  }
+
+  if (exit.big_error != 0 && exit.big_exit_time != 0) {
+    if (fabs(error) < exit.big_error) {
+      i += util::DELAY_TIME;
+      if (i > exit.big_exit_time) {
+        timers_reset();
+        return BIG_EXIT;
+      }
+    } else {
+      i = 0;
+    }
+  }
+
+  if (exit.velocity_exit_time != 0) {
+    if (fabs(derivative) <= velocity_zero_main) {
+      k += util::DELAY_TIME;
+      if (k > exit.velocity_exit_time) {
+        timers_reset();
+        return VELOCITY_EXIT;
+      }
+    } else {
+      k = 0;
+    }
+  }
+
+  return RUNNING;
+}
+
+exit_output PID::exit_condition(pros::Motor sensor, bool print) {
+  return exit_condition(std::vector<pros::Motor>{sensor}, print);
+}
+
+exit_output PID::exit_condition(std::vector<pros::Motor> sensor, bool print) {
+  if (exit.mA_timeout != 0) {
+    bool over = false;
+    for (auto& motor : sensor)
+      if (motor.is_over_current()) over = true;
+    if (over) {
+      l += util::DELAY_TIME;
+      if (l > exit.mA_timeout) {
+        timers_reset();
+        return mA_EXIT;
+      }
+    } else {
+      l = 0;
+    }
+  }
+  return exit_condition(print);
+}
+
+///
+// Slew
+///
+slew::slew() {}
+
+slew::slew(double distance, int minimum_speed) { constants_set(distance, minimum_speed); }
+
+void slew::constants_set(double distance, int minimum_speed) {
+  constants.distance_to_travel = distance;
+  constants.min_speed = minimum_speed;
+}
+
+slew::Constants slew::constants_get() { return constants; }
+
+// Ramps linearly from min_speed to the max speed over distance_to_travel
+void slew::initialize(bool enabled, double maximum_speed, double target, double current) {
+  is_enabled = enabled;
+  max_speed = maximum_speed;
+  sign = util::sgn(target - current);
+  x_intercept = current + (constants.distance_to_travel * sign);
+  y_intercept = max_speed * sign;
+  slope = ((sign * constants.min_speed) - y_intercept) / (x_intercept - current);
+}
+
+double slew::iterate(double current) {
+  if (is_enabled) {
+    error = x_intercept - current;
+    if (util::sgn(error) != sign)
+      is_enabled = false;
+    else
+      last_output = ((slope * error) + y_intercept) * sign;
+  }
+  if (!is_enabled) last_output = max_speed;
+  return last_output;
+}
+
+///
+// Tracking wheels
+///
+// The simulated robot doesn't have any, so nothing ever points at one
+double tracking_wheel::get() { return 0.0; }
+
+double tracking_wheel::distance_to_center_get() { return IS_FLIPPED ? -DISTANCE_TO_CENTER : DISTANCE_TO_CENTER; }
+
+///
+// Drive
+///
+Drive::Drive(std::vector<int> left_motor_ports, std::vector<int> right_motor_ports, int imu_port, double wheel_diameter, double ticks, double ratio)
+    : imu(imu_port),
+      left_tracker(-1, -1, false),
+      right_tracker(-1, -1, false),
+      left_rotation(-1),
+      right_rotation(-1),
+      ez_auto([this] { this->ez_auto_task(); }) {
+  odom_tracker_left = odom_tracker_right = odom_tracker_front = odom_tracker_back = nullptr;
+  for (auto port : left_motor_ports) left_motors.push_back(pros::Motor(port));
+  for (auto port : right_motor_ports) right_motors.push_back(pros::Motor(port));
+
+  // Ticks are counted off the first motor of each side, with the cartridge the drive has
+  for (auto& motor : left_motors) motor.set_encoder_units(pros::E_MOTOR_ENCODER_COUNTS);
+  for (auto& motor : right_motors) motor.set_encoder_units(pros::E_MOTOR_ENCODER_COUNTS);
+
+  WHEEL_DIAMETER = wheel_diameter;
+  RATIO = ratio;
+  CARTRIDGE = ticks;
+  CIRCUMFERENCE = WHEEL_DIAMETER * M_PI;
+  TICK_PER_REV = (50.0 * (3600.0 / CARTRIDGE)) * RATIO;
+  TICK_PER_INCH = TICK_PER_REV / CIRCUMFERENCE;
+  mode = DISABLE;
+
+  left_curve_scale = right_curve_scale = 0.0;
+  odom_path_smooth_constants_set(0.75, 0.03, 0.0001);
+}
+
+void Drive::initialize() {
+  imu.reset(true);
+  imu_calibration_complete = true;
+  drive_sensor_reset();
+}
+
+void Drive::ez_auto_task() {
+  while (true) {
+    switch (drive_mode_get()) {
+      case DRIVE:
+        drive_pid_task();
+        break;
+      case TURN:
+        turn_pid_task();
+        break;
+      default:
+        break;
+    }
+    pros::delay(util::DELAY_TIME);
+  }
+}
+
+void Drive::drive_mode_set(e_mode p_mode, bool stop_drive) {
+  mode = p_mode;
+  if (mode == DISABLE && stop_drive) private_drive_set(0, 0);
+}
+
+e_mode Drive::drive_mode_get() { return mode; }
+
+///
+// Motors and sensors
+///
+void Drive::private_drive_set(int left, int right) {
+  if (!drive_toggle) return;
+  for (auto& motor : left_motors) motor.move_voltage(left * (12000.0 / 127.0));
+  for (auto& motor : right_motors) motor.move_voltage(right * (12000.0 / 127.0));
+}
+
+void Drive::drive_set(int left, int right) {
+  drive_mode_set(DISABLE, false);
+  private_drive_set(left, right);
+}
+
+void Drive::drive_brake_set(pros::motor_brake_mode_e_t brake_type) {
+  CURRENT_BRAKE = brake_type;
+  for (auto& motor : left_motors) motor.set_brake_mode(brake_type);
+  for (auto& motor : right_motors) motor.set_brake_mode(brake_type);
+}
+
+double Drive::drive_sensor_left() { return left_motors.front().get_position() / TICK_PER_INCH; }
+
+double Drive::drive_sensor_right() { return right_motors.front().get_position() / TICK_PER_INCH; }
+
+void Drive::drive_sensor_reset() {
+  for (auto& motor : left_motors) motor.tare_position();
+  for (auto& motor : right_motors) motor.tare_position();
+}
+
+bool Drive::drive_current_left_over() { return left_motors.front().is_over_current(); }
+
+bool Drive::drive_current_right_over() { return right_motors.front().is_over_current(); }
+
+double Drive::drive_imu_get() { return imu.get_rotation() * IMU_SCALER; }
+
+double Drive::drive_imu_scaler_get() { return IMU_SCALER; }
+
+void Drive::drive_imu_reset(double new_heading) { imu.set_rotation(new_heading); }
+
+void Drive::drive_angle_set(okapi::QAngle p_angle) {
+  double angle = p_angle.convert(okapi::degree);
+  headingPID.target_set(angle);
+  turnPID.target_set(angle);
+  swingPID.target_set(angle);
+  imu.set_rotation(angle);
+  odom_current.theta = angle;
+}
+
+double Drive::drive_width_get() { return global_track_width; }
+
+void Drive::pid_targets_reset() {
+  headingPID.target_set(0);
+  leftPID.target_set(0);
+  rightPID.target_set(0);
+  turnPID.target_set(0);
+  swingPID.target_set(0);
+  odom_target = {0.0, 0.0, 0.0};
+}
+
+///
+// Constants
+///
+void Drive::pid_drive_constants_set(double p, double i, double d, double p_start_i) {
+  forward_drivePID.constants_set(p, i, d, p_start_i);
+  backward_drivePID.constants_set(p, i, d, p_start_i);
+  fwd_rev_drivePID.constants_set(p, i, d, p_start_i);
+}
+
+void Drive::pid_drive_constants_forward_set(double p, double i, double d, double p_start_i) { forward_drivePID.constants_set(p, i, d, p_start_i); }
+
+void Drive::pid_drive_constants_backward_set(double p, double i, double d, double p_start_i) { backward_drivePID.constants_set(p, i, d, p_start_i); }
+
+PID::Constants Drive::pid_drive_constants_forward_get() { return forward_drivePID.constants_get(); }
+
+PID::Constants Drive::pid_drive_constants_backward_get() { return backward_drivePID.constants_get(); }
+
+void Drive::pid_heading_constants_set(double p, double i, double d, double p_start_i) { headingPID.constants_set(p, i, d, p_start_i); }
+
+PID::Constants Drive::pid_heading_constants_get() { return headingPID.constants_get(); }
+
+void Drive::pid_turn_constants_set(double p, double i, double d, double p_start_i) { turnPID.constants_set(p, i, d, p_start_i); }
+
+PID::Constants Drive::pid_turn_constants_get() { return turnPID.constants_get(); }
+
+void Drive::pid_swing_constants_set(double p, double i, double d, double p_start_i) {
+  forward_swingPID.constants_set(p, i, d, p_start_i);
+  backward_swingPID.constants_set(p, i, d, p_start_i);
+  fwd_rev_swingPID.constants_set(p, i, d, p_start_i);
+}
+
+void Drive::pid_swing_constants_forward_set(double p, double i, double d, double p_start_i) { forward_swingPID.constants_set(p, i, d, p_start_i); }
+
+void Drive::pid_swing_constants_backward_set(double p, double i, double d, double p_start_i) { backward_swingPID.constants_set(p, i, d, p_start_i); }
+
+PID::Constants Drive::pid_swing_constants_forward_get() { return forward_swingPID.constants_get(); }
+
+PID::Constants Drive::pid_swing_constants_backward_get() { return backward_swingPID.constants_get(); }
+
+void Drive::pid_odom_angular_constants_set(double p, double i, double d, double p_start_i) { odom_angularPID.constants_set(p, i, d, p_start_i); }
+
+void Drive::pid_odom_boomerang_constants_set(double p, double i, double d, double p_start_i) { boomerangPID.constants_set(p, i, d, p_start_i); }
+
+void Drive::pid_drive_exit_condition_set(okapi::QTime p_small_exit_time, okapi::QLength p_small_error, okapi::QTime p_big_exit_time, okapi::QLength p_big_error, okapi::QTime p_velocity_exit_time, okapi::QTime p_mA_timeout, bool use_imu) {
+  using namespace okapi;
+  leftPID.exit_condition_set(p_small_exit_time.convert(millisecond), p_small_error.convert(inch), p_big_exit_time.convert(millisecond), p_big_error.convert(inch), p_velocity_exit_time.convert(millisecond), p_mA_timeout.convert(millisecond));
+  rightPID.exit_condition_set(p_small_exit_time.convert(millisecond), p_small_error.convert(inch), p_big_exit_time.convert(millisecond), p_big_error.convert(inch), p_velocity_exit_time.convert(millisecond), p_mA_timeout.convert(millisecond));
+}
+
+void Drive::pid_turn_exit_condition_set(okapi::QTime p_small_exit_time, okapi::QAngle p_small_error, okapi::QTime p_big_exit_time, okapi::QAngle p_big_error, okapi::QTime p_velocity_exit_time, okapi::QTime p_mA_timeout, bool use_imu) {
+  using namespace okapi;
+  turnPID.exit_condition_set(p_small_exit_time.convert(millisecond), p_small_error.convert(degree), p_big_exit_time.convert(millisecond), p_big_error.convert(degree), p_velocity_exit_time.convert(millisecond), p_mA_timeout.convert(millisecond));
+}
+
+void Drive::pid_swing_exit_condition_set(okapi::QTime p_small_exit_time, okapi::QAngle p_small_error, okapi::QTime p_big_exit_time, okapi::QAngle p_big_error, okapi::QTime p_velocity_exit_time, okapi::QTime p_mA_timeout, bool use_imu) {
+  using namespace okapi;
+  swingPID.exit_condition_set(p_small_exit_time.convert(millisecond), p_small_error.convert(degree), p_big_exit_time.convert(millisecond), p_big_error.convert(degree), p_velocity_exit_time.convert(millisecond), p_mA_timeout.convert(millisecond));
+}
+
+void Drive::pid_odom_drive_exit_condition_set(okapi::QTime p_small_exit_time, okapi::QLength p_small_error, okapi::QTime p_big_exit_time, okapi::QLength p_big_error, okapi::QTime p_velocity_exit_time, okapi::QTime p_mA_timeout, bool use_imu) {
+  using namespace okapi;
+  xyPID.exit_condition_set(p_small_exit_time.convert(millisecond), p_small_error.convert(inch), p_big_exit_time.convert(millisecond), p_big_error.convert(inch), p_velocity_exit_time.convert(millisecond), p_mA_timeout.convert(millisecond));
+}
+
+void Drive::pid_odom_turn_exit_condition_set(okapi::QTime p_small_exit_time, okapi::QAngle p_small_error, okapi::QTime p_big_exit_time, okapi::QAngle p_big_error, okapi::QTime p_velocity_exit_time, okapi::QTime p_mA_timeout, bool use_imu) {
+  using namespace okapi;
+  current_a_odomPID.exit_condition_set(p_small_exit_time.convert(millisecond), p_small_error.convert(degree), p_big_exit_time.convert(millisecond), p_big_error.convert(degree), p_velocity_exit_time.convert(millisecond), p_mA_timeout.convert(millisecond));
+}
+
+void Drive::pid_drive_chain_constant_set(okapi::QLength input) {
+  drive_forward_motion_chain_scale = drive_backward_motion_chain_scale = input.convert(okapi::inch);
+}
+
+void Drive::pid_turn_chain_constant_set(okapi::QAngle input) { turn_motion_chain_scale = input.convert(okapi::degree); }
+
+void Drive::pid_swing_chain_constant_set(okapi::QAngle input) {
+  swing_forward_motion_chain_scale = swing_backward_motion_chain_scale = input.convert(okapi::degree);
+}
+
+void Drive::slew_drive_constants_set(okapi::QLength distance, int min_speed) {
+  slew_forward.constants_set(distance.convert(okapi::inch), min_speed);
+  slew_backward.constants_set(distance.convert(okapi::inch), min_speed);
+}
+
+void Drive::slew_turn_constants_set(okapi::QAngle distance, int min_speed) { slew_turn.constants_set(distance.convert(okapi::degree), min_speed); }
+
+void Drive::slew_swing_constants_set(okapi::QLength distance, int min_speed) {
+  slew_swing_forward.constants_set(distance.convert(okapi::inch), min_speed);
+  slew_swing_backward.constants_set(distance.convert(okapi::inch), min_speed);
+  slew_swing_using_angle = false;
+}
+
+bool Drive::slew_turn_get() { return global_turn_slew_enabled; }
+
+// Only stored, swings in the routines go through motion::
+void Drive::slew_swing_set(bool slew_on) { global_forward_swing_slew_enabled = global_backward_swing_slew_enabled = slew_on; }
+
+void Drive::pid_angle_behavior_set(e_angle_behavior behavior) { default_turn_type = default_swing_type = default_odom_type = behavior; }
+
+e_angle_behavior Drive::pid_turn_behavior_get() { return default_turn_type; }
+
+e_angle_behavior Drive::pid_swing_behavior_get() { return default_swing_type; }
+
+///
+// Odom settings, only stored, the project tracks the pose itself
+///
+void Drive::odom_pose_set(pose itarget) { odom_current = itarget; }
+
+pose Drive::odom_pose_get() { return odom_current; }
+
+void Drive::odom_turn_bias_set(double bias) { odom_turn_bias_amount = bias; }
+
+double Drive::odom_turn_bias_get() { return odom_turn_bias_amount; }
+
+void Drive::odom_look_ahead_set(okapi::QLength distance) { LOOK_AHEAD = distance.convert(okapi::inch); }
+
+double Drive::odom_look_ahead_get() { return LOOK_AHEAD; }
+
+double Drive::odom_path_spacing_get() { return SPACING; }
+
+void Drive::odom_boomerang_distance_set(okapi::QLength distance) { max_boomerang_distance = distance.convert(okapi::inch); }
+
+void Drive::odom_boomerang_dlead_set(double input) { dlead = input; }
+
+void Drive::odom_path_smooth_constants_set(double weight_smooth, double weight_data, double tolerance) {
+  odom_smooth_weight_smooth = weight_smooth;
+  odom_smooth_weight_data = weight_data;
+  odom_smooth_tolerance = tolerance;
+}
+
+std::vector<double> Drive::odom_path_smooth_constants_get() { return {odom_smooth_weight_smooth, odom_smooth_weight_data, odom_smooth_tolerance}; }
+
+///
+// Odom math
+///
+// Arc the tracker moved through, turned from robot to field coordinates by the average heading
+pose Drive::solve_xy_vert(float p_track_width, float current_t, float delta_vert, float delta_t) {
+  float local_y = delta_t == 0.0 ? delta_vert : 2.0 * sin(delta_t / 2.0) * ((delta_vert / delta_t) + p_track_width);
+  float angle = current_t - (delta_t / 2.0);
+  return {local_y * sin(angle), local_y * cos(angle), 0.0};
+}
+
+pose Drive::solve_xy_horiz(float p_track_width, float current_t, float delta_horiz, float delta_t) {
+  float local_x = delta_t == 0.0 ? delta_horiz : 2.0 * sin(delta_t / 2.0) * ((delta_horiz / delta_t) + p_track_width);
+  float angle = current_t - (delta_t / 2.0);
+  return {local_x * cos(angle), -local_x * sin(angle), 0.0};
+}
+
+///
+// Odom paths, only processed, odom motions in the routines go through motion::
+///
+// Points every SPACING inches from the last target through each movement, each one leading to the next movement
+std::vector<odom> Drive::inject_points(std::vector<odom> imovements) {
+  injected_pp_index.clear();
+  std::vector<odom> input = imovements;
+  input.insert(input.begin(), {{odom_target.x, odom_target.y, ANGLE_NOT_SET}, imovements[0].drive_direction, imovements[0].max_xy_speed});
+
+  std::vector<odom> output;
+  for (int i = 0; i < (int)input.size() - 1; i++) {
+    int fit = util::distance_to_point(input[i + 1].target, input[i].target) / SPACING;
+    double angle = util::absolute_angle_to_point(input[i + 1].target, input[i].target);
+
+    output.push_back({input[i].target, input[i + 1].drive_direction, input[i + 1].max_xy_speed, input[i + 1].turn_behavior});
+    injected_pp_index.push_back(output.size() - 1);
+    for (int j = 0; j < fit; j++) {
+      pose last = output.back().target;
+      pose next = {last.x + sin(util::to_rad(angle)) * SPACING, last.y + cos(util::to_rad(angle)) * SPACING, ANGLE_NOT_SET};
+      output.push_back({next, input[i + 1].drive_direction, input[i + 1].max_xy_speed, input[i + 1].turn_behavior});
+    }
+  }
+  output.push_back(input.back());
+  injected_pp_index.push_back(output.size() - 1);
+  return output;
+}
+
+// Pulls each point toward its neighbors and its original spot until a pass moves less than tolerance
+std::vector<odom> Drive::smooth_path(std::vector<odom> ipath, double weight_smooth, double weight_data, double tolerance) {
+  std::vector<odom> output = ipath;
+  double change = tolerance;
+  while (change >= tolerance) {
+    change = 0.0;
+    for (int i = 1; i < (int)output.size() - 1; i++) {
+      pose& p = output[i].target;
+      double x = p.x, y = p.y;
+      p.x += weight_data * (ipath[i].target.x - p.x) + weight_smooth * (output[i - 1].target.x + output[i + 1].target.x - 2.0 * p.x);
+      p.y += weight_data * (ipath[i].target.y - p.y) + weight_smooth * (output[i - 1].target.y + output[i + 1].target.y - 2.0 * p.y);
+      change += fabs(x - p.x) + fabs(y - p.y);
+    }
+  }
+  return output;
+}
+
+void Drive::pid_odom_injected_pp_set(std::vector<odom> imovements, bool slew_on) {
+  if (imovements.empty()) return;
+  pp_movements = inject_points(imovements);
+}
+
+void Drive::pid_odom_smooth_pp_set(std::vector<odom> imovements, bool slew_on) {
+  if (imovements.empty()) return;
+  pp_movements = smooth_path(inject_points(imovements), odom_smooth_weight_smooth, odom_smooth_weight_data, odom_smooth_tolerance);
+}
+
+///
+// Opcontrol
+///
+// EZ-Template's exponential joystick curve, 0 leaves the input alone
+double Drive::opcontrol_curve_left(double x) {
+  if (left_curve_scale == 0.0) return x;
+  return (powf(2.718, -(left_curve_scale / 10)) + powf(2.718, (fabs(x) - 127) / 10) * (1 - powf(2.718, -(left_curve_scale / 10)))) * x;
+}
+
+void Drive::pid_drive_toggle(bool toggle) { drive_toggle = toggle; }
+
+bool Drive::pid_drive_toggle_get() { return drive_toggle; }
+
+void Drive::pid_print_toggle(bool toggle) { print_toggle = toggle; }
+
+bool Drive::pid_print_toggle_get() { return print_toggle; }
+
+///
+// Drive motions
+///
+void Drive::pid_drive_set(okapi::QLength p_target, int speed) {
+  bool slew_on = p_target.convert(okapi::inch) >= 0.0 ? global_forward_drive_slew_enabled : global_backward_drive_slew_enabled;
+  pid_drive_set(p_target, speed, slew_on, true);
+}
+
+void Drive::pid_drive_set(double target, int speed) { pid_drive_set(target * okapi::inch, speed); }
+
+void Drive::pid_drive_set(okapi::QLength p_target, int speed, bool slew_on, bool toggle_heading) {
+  double target = p_target.convert(okapi::inch);
+  max_speed = abs(speed);
+  heading_on = toggle_heading;
+
+  l_start = drive_sensor_left();
+  r_start = drive_sensor_right();
+  double l_target = l_start + target;
+  double r_target = r_start + target;
+  bool is_backwards = l_target < l_start && r_target < r_start;
+
+  // Forward and backward motions can be tuned separately
+  PID::Constants pid_consts = is_backwards ? backward_drivePID.constants_get() : forward_drivePID.constants_get();
+  slew::Constants slew_consts = is_backwards ? slew_backward.constants_get() : slew_forward.constants_get();
+  leftPID.constants_set(pid_consts.kp, pid_consts.ki, pid_consts.kd, pid_consts.start_i);
+  rightPID.constants_set(pid_consts.kp, pid_consts.ki, pid_consts.kd, pid_consts.start_i);
+  slew_left.constants_set(slew_consts.distance_to_travel, slew_consts.min_speed);
+  slew_right.constants_set(slew_consts.distance_to_travel, slew_consts.min_speed);
+
+  leftPID.target_set(l_target);
+  rightPID.target_set(r_target);
+  slew_left.initialize(slew_on, max_speed, l_target, drive_sensor_left());
+  slew_right.initialize(slew_on, max_speed, r_target, drive_sensor_right());
+
+  drive_mode_set(DRIVE);
+}
+
+void Drive::drive_pid_task() {
+  leftPID.compute(drive_sensor_left());
+  rightPID.compute(drive_sensor_right());
+  headingPID.compute(drive_imu_get());
+
+  // Slew returns max_speed once it's done, so this is also the speed cap
+  double l_slew_out = slew_left.iterate(drive_sensor_left());
+  double r_slew_out = slew_right.iterate(drive_sensor_right());
+  double l_drive_out = util::clamp(leftPID.output, l_slew_out, -l_slew_out);
+  double r_drive_out = util::clamp(rightPID.output, r_slew_out, -r_slew_out);
+
+  double gyro_out = heading_on ? headingPID.output : 0.0;
+  double l_out = l_drive_out + gyro_out;
+  double r_out = r_drive_out - gyro_out;
+
+  // Scale both sides down together so heading correction survives the cap
+  double max_slew_out = fmin(fabs(l_slew_out), fabs(r_slew_out));
+  if (fabs(l_out) > max_slew_out || fabs(r_out) > max_slew_out) {
+    if (fabs(l_out) > fabs(r_out)) {
+      r_out = r_out * (max_slew_out / fabs(l_out));
+      l_out = util::clamp(l_out, max_slew_out, -max_slew_out);
+    } else {
+      l_out = l_out * (max_slew_out / fabs(r_out));
+      r_out = util::clamp(r_out, max_slew_out, -max_slew_out);
+    }
+  }
+
+  private_drive_set(l_out, r_out);
+}
+
+///
+// Turn motions
+///
+double Drive::new_turn_target_compute(double target, double current, e_angle_behavior behavior) {
+  switch (behavior) {
+    case shortest:
+      return util::turn_shortest(target, current);
+    case longest:
+      return util::turn_longest(target, current);
+    case left_turn:
+      return current - fmod(fmod(current - target, 360.0) + 360.0, 360.0);
+    case right_turn:
+      return current + fmod(fmod(target - current, 360.0) + 360.0, 360.0);
+    default:
+      return target;
+  }
+}
+
+void Drive::pid_turn_set(okapi::QAngle p_target, int speed) {
+  double target = new_turn_target_compute(p_target.convert(okapi::degree), drive_imu_get(), default_turn_type);
+  turnPID.target_set(target);
+  headingPID.target_set(target);  // The next drive holds this heading
+  max_speed = abs(speed);
+  slew_turn.initialize(slew_turn_get(), max_speed, target, drive_imu_get());
+  drive_mode_set(TURN);
+}
+
+void Drive::turn_pid_task() {
+  turnPID.compute(drive_imu_get());
+  double slew_out = slew_turn.iterate(drive_imu_get());
+  double turn_out = util::clamp(turnPID.output, slew_out, -slew_out);
+  private_drive_set(turn_out, -turn_out);
+}
+
+///
+// Waiting
+///
+void Drive::pid_wait() {
+  pros::delay(util::DELAY_TIME);  // Let the PID run at least once
+
+  if (mode == DRIVE) {
+    exit_output left_exit = RUNNING;
+    exit_output right_exit = RUNNING;
+    while (left_exit == RUNNING || right_exit == RUNNING) {
+      left_exit = left_exit != RUNNING ? left_exit : leftPID.exit_condition(left_motors[0]);
+      right_exit = right_exit != RUNNING ? right_exit : rightPID.exit_condition(right_motors[0]);
+      pros::delay(util::DELAY_TIME);
+    }
+    interfered = left_exit == mA_EXIT || left_exit == VELOCITY_EXIT || right_exit == mA_EXIT || right_exit == VELOCITY_EXIT;
+  } else if (mode == TURN) {
+    exit_output turn_exit = RUNNING;
+    while (turn_exit == RUNNING) {
+      turn_exit = turnPID.exit_condition({left_motors[0], right_motors[0]});
+      pros::delay(util::DELAY_TIME);
+    }
+    interfered = turn_exit == mA_EXIT || turn_exit == VELOCITY_EXIT;
+  }
+}
+}  // namespace ez
@@ -0,0 +1,442 @@
+// Host versions of the PROS devices, backed by the port table in host.hpp.
+
+#include <cmath>
+
+#include "host.hpp"
+#include "pros/adi.hpp"
+#include "pros/distance.hpp"
+#include "pros/imu.hpp"
+#include "pros/motors.hpp"
+#include "pros/rotation.hpp"
+
+namespace host {
+static const int PORTS = 21;
+static const int ADI_PORTS = 8;
+
+port& port_get(int port) {
+  static host::port ports[PORTS + 1];
+  port = std::abs(port);
+  return ports[port >= 1 && port <= PORTS ? port : 0];
+}
+
+static int adi[ADI_PORTS + 1];
+
+static int adi_index(int port) {
+  if (port >= 'a' && port <= 'h') return port - 'a' + 1;
+  if (port >= 'A' && port <= 'H') return port - 'A' + 1;
+  return port >= 1 && port <= ADI_PORTS ? port : 0;
+}
+
+int adi_get(int port) { return adi[adi_index(port)]; }
+}  // namespace host
+
+namespace pros {
+inline namespace v5 {
+///
+// Device
+///
+Device::Device(const std::uint8_t port) : _port(port) {}
+
+std::uint8_t Device::get_port(void) const { return _port; }
+
+bool Device::is_installed() { return true; }
+
+///
+// Motor
+///
+// Encoder counts per revolution of the cartridge output
+static double counts_per_rev(int gearing) {
+  switch (gearing) {
+    case E_MOTOR_GEAR_RED:
+      return 1800.0;
+    case E_MOTOR_GEAR_BLUE:
+      return 300.0;
+    default:
+      return 900.0;
+  }
+}
+
+static double free_rpm(int gearing) {
+  switch (gearing) {
+    case E_MOTOR_GEAR_RED:
+      return 100.0;
+    case E_MOTOR_GEAR_BLUE:
+      return 600.0;
+    default:
+      return 200.0;
+  }
+}
+
+Motor::Motor(const std::int8_t port, const MotorGears gearset, const MotorUnits encoder_units)
+    : Device(std::abs(port), DeviceType::motor), _port(port) {
+  if (gearset != MotorGears::invalid) set_gearing(gearset);
+  if (encoder_units != MotorUnits::invalid) set_encoder_units(encoder_units);
+}
+
+// Everything below is in the direction the motor turns, so reversed motors flip the sign
+static int direction(std::int8_t port) { return port < 0 ? -1 : 1; }
+
+std::int32_t Motor::move(std::int32_t voltage) const {
+  host::port_get(_port).output = std::clamp(voltage, -127, 127) * direction(_port);
+  return 1;
+}
+
+std::int32_t Motor::move_voltage(const std::int32_t voltage) const {
+  host::port_get(_port).output = std::clamp(voltage, -12000, 12000) * 127.0 / 12000.0 * direction(_port);
+  return 1;
+}
+
+// Velocity control is open loop here, good enough for mechanisms
+std::int32_t Motor::move_velocity(const std::int32_t velocity) const {
+  host::port& p = host::port_get(_port);
+  p.output = std::clamp(velocity / free_rpm(p.gearing) * 127.0, -127.0, 127.0) * direction(_port);
+  return 1;
+}
+
+// Position control isn't modeled, nothing on the simulated robot uses it
+std::int32_t Motor::move_absolute(const double position, const std::int32_t velocity) const { return brake(); }
+
+std::int32_t Motor::move_relative(const double position, const std::int32_t velocity) const { return brake(); }
+
+std::int32_t Motor::brake(void) const {
+  host::port_get(_port).output = 0.0;
+  return 1;
+}
+
+std::int32_t Motor::modify_profiled_velocity(const std::int32_t velocity) const { return move_velocity(velocity); }
+
+double Motor::get_target_position(const std::uint8_t index) const { return 0.0; }
+
+std::int32_t Motor::get_target_velocity(const std::uint8_t index) const {
+  host::port& p = host::port_get(_port);
+  return p.output / 127.0 * free_rpm(p.gearing) * direction(_port);
+}
+
+double Motor::get_actual_velocity(const std::uint8_t index) const { return host::port_get(_port).velocity * direction(_port); }
+
+std::int32_t Motor::get_current_draw(const std::uint8_t index) const { return host::port_get(_port).current; }
+
+std::int32_t Motor::get_direction(const std::uint8_t index) const { return get_actual_velocity() < 0.0 ? -1 : 1; }
+
+double Motor::get_efficiency(const std::uint8_t index) const { return 100.0; }
+
+std::uint32_t Motor::get_faults(const std::uint8_t index) const { return 0; }
+
+std::uint32_t Motor::get_flags(const std::uint8_t index) const { return 0; }
+
+double Motor::get_position(const std::uint8_t index) const {
+  host::port& p = host::port_get(_port);
+  double revolutions = (p.position - p.zero) * direction(_port);
+  switch (p.units) {
+    case E_MOTOR_ENCODER_ROTATIONS:
+      return revolutions;
+    case E_MOTOR_ENCODER_COUNTS:
+      return revolutions * counts_per_rev(p.gearing);
+    default:
+      return revolutions * 360.0;
+  }
+}
+
+double Motor::get_power(const std::uint8_t index) const { return fabs(get_voltage() / 1000.0 * get_current_draw() / 1000.0); }
+
+std::int32_t Motor::get_raw_position(std::uint32_t* const timestamp, const std::uint8_t index) const {
+  if (timestamp != nullptr) *timestamp = pros::c::millis();
+  host::port& p = host::port_get(_port);
+  return p.position * counts_per_rev(p.gearing) * direction(_port);
+}
+
+double Motor::get_temperature(const std::uint8_t index) const { return 25.0; }
+
+double Motor::get_torque(const std::uint8_t index) const { return 0.0; }
+
+std::int32_t Motor::get_voltage(const std::uint8_t index) const { return host::port_get(_port).output / 127.0 * 12000.0 * direction(_port); }
+
+std::int32_t Motor::is_over_current(const std::uint8_t index) const {
+  host::port& p = host::port_get(_port);
+  return p.current >= p.current_limit;
+}
+
+std::int32_t Motor::is_over_temp(const std::uint8_t index) const { return 0; }
+
+MotorBrake Motor::get_brake_mode(const std::uint8_t index) const { return (MotorBrake)host::port_get(_port).brake_mode; }
+
+std::int32_t Motor::get_current_limit(const std::uint8_t index) const { return host::port_get(_port).current_limit; }
+
+MotorUnits Motor::get_encoder_units(const std::uint8_t index) const { return (MotorUnits)host::port_get(_port).units; }
+
+MotorGears Motor::get_gearing(const std::uint8_t index) const { return (MotorGears)host::port_get(_port).gearing; }
+
+std::int32_t Motor::get_voltage_limit(const std::uint8_t index) const { return 0; }
+
+std::int32_t Motor::is_reversed(const std::uint8_t index) const { return _port < 0; }
+
+std::int32_t Motor::set_brake_mode(const MotorBrake mode, const std::uint8_t index) const {
+  host::port_get(_port).brake_mode = (int)mode;
+  return 1;
+}
+
+std::int32_t Motor::set_brake_mode(const pros::motor_brake_mode_e_t mode, const std::uint8_t index) const {
+  host::port_get(_port).brake_mode = mode;
+  return 1;
+}
+
+std::int32_t Motor::set_current_limit(const std::int32_t limit, const std::uint8_t index) const {
+  host::port_get(_port).current_limit = limit;
+  return 1;
+}
+
+std::int32_t Motor::set_encoder_units(const MotorUnits units, const std::uint8_t index) const {
+  host::port_get(_port).units = (int)units;
+  return 1;
+}
+
+std::int32_t Motor::set_encoder_units(const pros::motor_encoder_units_e_t units, const std::uint8_t index) const {
+  host::port_get(_port).units = units;
+  return 1;
+}
+
+std::int32_t Motor::set_gearing(const MotorGears gearset, const std::uint8_t index) const {
+  host::port_get(_port).gearing = (int)gearset;
+  return 1;
+}
+
+std::int32_t Motor::set_gearing(const pros::motor_gearset_e_t gearset, const std::uint8_t index) const {
+  host::port_get(_port).gearing = gearset;
+  return 1;
+}
+
+std::int32_t Motor::set_reversed(const bool reverse, const std::uint8_t index) {
+  _port = reverse ? -std::abs(_port) : std::abs(_port);
+  return 1;
+}
+
+std::int32_t Motor::set_voltage_limit(const std::int32_t limit, const std::uint8_t index) const { return 1; }
+
+std::int32_t Motor::set_zero_position(const double position, const std::uint8_t index) const {
+  host::port& p = host::port_get(_port);
+  double revolutions = position / 360.0;
+  if (p.units == E_MOTOR_ENCODER_ROTATIONS)
+    revolutions = position;
+  else if (p.units == E_MOTOR_ENCODER_COUNTS)
+    revolutions = position / counts_per_rev(p.gearing);
+  p.zero = p.position - revolutions * direction(_port);
+  return 1;
+}
+
+std::int32_t Motor::tare_position(const std::uint8_t index) const { return set_zero_position(0.0); }
+
+std::int8_t Motor::size(void) const { return 1; }
+
+std::vector<Motor> Motor::get_all_devices() { return {}; }
+
+std::int8_t Motor::get_port(const std::uint8_t index) const { return _port; }
+
+// A single motor is a group of one
+std::vector<double> Motor::get_target_position_all(void) const { return {get_target_position()}; }
+std::vector<std::int32_t> Motor::get_target_velocity_all(void) const { return {get_target_velocity()}; }
+std::vector<double> Motor::get_actual_velocity_all(void) const { return {get_actual_velocity()}; }
+std::vector<std::int32_t> Motor::get_current_draw_all(void) const { return {get_current_draw()}; }
+std::vector<std::int32_t> Motor::get_direction_all(void) const { return {get_direction()}; }
+std::vector<double> Motor::get_efficiency_all(void) const { return {get_efficiency()}; }
+std::vector<std::uint32_t> Motor::get_faults_all(void) const { return {get_faults()}; }
+std::vector<std::uint32_t> Motor::get_flags_all(void) const { return {get_flags()}; }
+std::vector<double> Motor::get_position_all(void) const { return {get_position()}; }
+std::vector<double> Motor::get_power_all(void) const { return {get_power()}; }
+std::vector<std::int32_t> Motor::get_raw_position_all(std::uint32_t* const timestamp) const { return {get_raw_position(timestamp)}; }
+std::vector<double> Motor::get_temperature_all(void) const { return {get_temperature()}; }
+std::vector<double> Motor::get_torque_all(void) const { return {get_torque()}; }
+std::vector<std::int32_t> Motor::get_voltage_all(void) const { return {get_voltage()}; }
+std::vector<std::int32_t> Motor::is_over_current_all(void) const { return {is_over_current()}; }
+std::vector<std::int32_t> Motor::is_over_temp_all(void) const { return {is_over_temp()}; }
+std::vector<MotorBrake> Motor::get_brake_mode_all(void) const { return {get_brake_mode()}; }
+std::vector<std::int32_t> Motor::get_current_limit_all(void) const { return {get_current_limit()}; }
+std::vector<MotorUnits> Motor::get_encoder_units_all(void) const { return {get_encoder_units()}; }
+std::vector<MotorGears> Motor::get_gearing_all(void) const { return {get_gearing()}; }
+std::vector<std::int8_t> Motor::get_port_all(void) const { return {get_port()}; }
+std::vector<std::int32_t> Motor::get_voltage_limit_all(void) const { return {get_voltage_limit()}; }
+std::vector<std::int32_t> Motor::is_reversed_all(void) const { return {is_reversed()}; }
+std::int32_t Motor::set_brake_mode_all(const MotorBrake mode) const { return set_brake_mode(mode); }
+std::int32_t Motor::set_brake_mode_all(const pros::motor_brake_mode_e_t mode) const { return set_brake_mode(mode); }
+std::int32_t Motor::set_current_limit_all(const std::int32_t limit) const { return set_current_limit(limit); }
+std::int32_t Motor::set_encoder_units_all(const MotorUnits units) const { return set_encoder_units(units); }
+std::int32_t Motor::set_encoder_units_all(const pros::motor_encoder_units_e_t units) const { return set_encoder_units(units); }
+std::int32_t Motor::set_gearing_all(const MotorGears gearset) const { return set_gearing(gearset); }
+std::int32_t Motor::set_gearing_all(const pros::motor_gearset_e_t gearset) const { return set_gearing(gearset); }
+std::int32_t Motor::set_reversed_all(const bool reverse) { return set_reversed(reverse); }
+std::int32_t Motor::set_voltage_limit_all(const std::int32_t limit) const { return set_voltage_limit(limit); }
+std::int32_t Motor::set_zero_position_all(const double position) const { return set_zero_position(position); }
+std::int32_t Motor::tare_position_all(void) const { return tare_position(); }
+
+///
+// IMU
+///
+// Calibration is instant, the simulated IMU is ready as soon as it's made
+std::int32_t Imu::reset(bool blocking) const { return 1; }
+
+std::int32_t Imu::set_data_rate(std::uint32_t rate) const { return 1; }
+
+double Imu::get_rotation() const {
+  host::port& p = host::port_get(_port);
+  return p.heading - p.heading_zero;
+}
+
+double Imu::get_heading() const {
+  double heading = fmod(get_rotation(), 360.0);
+  return heading < 0.0 ? heading + 360.0 : heading;
+}
+
+pros::quaternion_s_t Imu::get_quaternion() const {
+  double yaw = -get_rotation() * M_PI / 180.0;
+  return {0.0, 0.0, sin(yaw / 2.0), cos(yaw / 2.0)};
+}
+
+pros::euler_s_t Imu::get_euler() const { return {0.0, 0.0, get_yaw()}; }
+
+double Imu::get_pitch() const { return 0.0; }
+
+double Imu::get_roll() const { return 0.0; }
+
+double Imu::get_yaw() const {
+  double yaw = get_heading();
+  return yaw > 180.0 ? yaw - 360.0 : yaw;
+}
+
+// z is counterclockwise positive, headings are clockwise positive
+pros::imu_gyro_s_t Imu::get_gyro_rate() const { return {0.0, 0.0, -host::port_get(_port).rate}; }
+
+std::int32_t Imu::set_rotation(const double target) const {
+  host::port& p = host::port_get(_port);
+  p.heading_zero = p.heading - target;
+  return 1;
+}
+
+std::int32_t Imu::set_heading(const double target) const { return set_rotation(target); }
+
+std::int32_t Imu::set_yaw(const double target) const { return set_rotation(target); }
+
+std::int32_t Imu::set_pitch(const double target) const { return 1; }
+
+std::int32_t Imu::set_roll(const double target) const { return 1; }
+
+std::int32_t Imu::set_euler(const pros::euler_s_t target) const { return set_rotation(target.yaw); }
+
+std::int32_t Imu::tare_rotation() const { return set_rotation(0.0); }
+
+std::int32_t Imu::tare_heading() const { return set_rotation(0.0); }
+
+std::int32_t Imu::tare_yaw() const { return set_rotation(0.0); }
+
+std::int32_t Imu::tare_pitch() const { return 1; }
+
+std::int32_t Imu::tare_roll() const { return 1; }
+
+std::int32_t Imu::tare_euler() const { return set_rotation(0.0); }
+
+std::int32_t Imu::tare() const { return set_rotation(0.0); }
+
+pros::imu_accel_s_t Imu::get_accel() const { return {0.0, 0.0, 1.0}; }
+
+pros::ImuStatus Imu::get_status() const { return pros::ImuStatus::ready; }
+
+bool Imu::is_calibrating() const { return false; }
+
+imu_orientation_e_t Imu::get_physical_orientation() const { return E_IMU_Z_UP; }
+
+///
+// Distance
+///
+Distance::Distance(const std::uint8_t port) : Device(port, DeviceType::distance) {}
+
+std::int32_t Distance::get() { return host::port_get(_port).distance; }
+
+std::int32_t Distance::get_distance() { return get(); }
+
+std::int32_t Distance::get_confidence() { return get() < 9999 ? 63 : 0; }
+
+std::int32_t Distance::get_object_size() { return get() < 9999 ? 200 : -1; }
+
+double Distance::get_object_velocity() { return 0.0; }
+
+///
+// Rotation
+///
+// Rotation sensors aren't on the simulated robot, they read as if they never moved
+Rotation::Rotation(const std::int8_t port) : Device(std::abs(port), DeviceType::rotation) {}
+
+std::int32_t Rotation::reset() { return 1; }
+
+std::int32_t Rotation::set_data_rate(std::uint32_t rate) const { return 1; }
+
+std::int32_t Rotation::set_position(std::uint32_t position) const { return 1; }
+
+std::int32_t Rotation::reset_position(void) const { return 1; }
+
+std::int32_t Rotation::get_position() const { return 0; }
+
+std::int32_t Rotation::get_velocity() const { return 0; }
+
+std::int32_t Rotation::get_angle() const { return 0; }
+
+std::int32_t Rotation::set_reversed(bool value) const { return 1; }
+
+std::int32_t Rotation::reverse() const { return 1; }
+
+std::int32_t Rotation::get_reversed() const { return 0; }
+}  // namespace v5
+
+///
+// Three wire ports
+///
+namespace adi {
+Port::Port(std::uint8_t adi_port, adi_port_config_e_t type) : _smart_port(INTERNAL_ADI_PORT), _adi_port(adi_port) {}
+
+std::int32_t Port::set_value(std::int32_t value) const {
+  host::adi[host::adi_index(_adi_port)] = value;
+  return 1;
+}
+
+ext_adi_port_tuple_t Port::get_port() const { return {_smart_port, _adi_port, 0}; }
+
+DigitalOut::DigitalOut(std::uint8_t adi_port, bool init_state) : Port(adi_port, E_ADI_DIGITAL_OUT) { set_value(init_state); }
+
+Pneumatics::Pneumatics(std::uint8_t adi_port, bool start_extended, bool extended_is_low)
+    : DigitalOut(adi_port, start_extended != extended_is_low), state(start_extended != extended_is_low), extended_is_low(extended_is_low) {}
+
+std::int32_t Pneumatics::extend() {
+  state = !extended_is_low;
+  return set_value(state);
+}
+
+std::int32_t Pneumatics::retract() {
+  state = extended_is_low;
+  return set_value(state);
+}
+
+std::int32_t Pneumatics::toggle() { return is_extended() ? retract() : extend(); }
+
+bool Pneumatics::is_extended() const { return state != extended_is_low; }
+
+// Trackers aren't on the simulated robot either
+Encoder::Encoder(std::uint8_t adi_port_top, std::uint8_t adi_port_bottom, bool reversed)
+    : Port(adi_port_top, E_ADI_LEGACY_ENCODER), _port_pair(adi_port_top, adi_port_bottom) {}
+
+std::int32_t Encoder::reset() const { return 1; }
+
+std::int32_t Encoder::get_value() const { return 0; }
+
+ext_adi_port_tuple_t Encoder::get_port() const { return {_smart_port, std::get<0>(_port_pair), std::get<1>(_port_pair)}; }
+}  // namespace adi
+
+///
+// Brain
+///
+// DriveSim's battery holds its voltage, so compensation never has anything to do
+namespace battery {
+int32_t get_voltage(void) { return 12800; }
+}  // namespace battery
+
+// The simulator only runs autons, it's never disabled
+namespace competition {
+std::uint8_t is_disabled(void) { return false; }
+}  // namespace competition
+}  // namespace pros
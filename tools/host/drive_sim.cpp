@@ -0,0 +1,122 @@
+#include "drive_sim.hpp"
+
+// Everything internal is SI, everything public is inches and degrees
+static const double METERS_PER_INCH = 0.0254;
+static const double NOMINAL_VOLTAGE = 12.0;
+static const double STALL_CURRENT = 2.5;
+static const double SUBSTEP = 0.001;
+
+DriveSim::DriveSim() : DriveSim(Constants{}) {}
+
+DriveSim::DriveSim(Constants constants, unsigned seed) : constants(constants), rng(seed) {
+  reset();
+}
+
+void DriveSim::reset(ez::pose pose) {
+  current = State{};
+  current.pose = pose;
+  current.imu_heading = pose.theta;
+  left_output = 0.0;
+  right_output = 0.0;
+  imu_bias = 0.0;
+}
+
+void DriveSim::drive_set(double left, double right) {
+  left_output = ez::util::clamp(left, 127);
+  right_output = ez::util::clamp(right, 127);
+}
+
+DriveSim::State DriveSim::state() { return current; }
+
+double DriveSim::speed_max() { return constants.wheel_rpm / 60.0 * M_PI * constants.wheel_diameter; }
+
+// Returns the force one side of the drive puts into the ground in N
+double DriveSim::motor_force(double command, double wheel_velocity, double* current_ma) {
+  double radius = constants.wheel_diameter * METERS_PER_INCH / 2.0;
+  double gear = constants.motor_rpm / constants.wheel_rpm;
+  double free_speed = constants.wheel_rpm * 2.0 * M_PI / 60.0;
+
+  // Motors can't put out more than the battery has
+  double voltage = ez::util::clamp(command / 127.0 * NOMINAL_VOLTAGE, constants.battery_voltage);
+
+  // Linear DC motor model, torque falls off with back emf
+  double torque = constants.motor_stall_torque * (voltage / NOMINAL_VOLTAGE - (wheel_velocity / radius) / free_speed);
+
+  // Current draw is proportional to torque, and the motor firmware caps it
+  double max_torque = constants.motor_stall_torque * constants.motor_current_limit / STALL_CURRENT;
+  torque = ez::util::clamp(torque, max_torque);
+  *current_ma = fabs(torque / constants.motor_stall_torque * STALL_CURRENT) * 1000.0;
+
+  return constants.motors_per_side * torque * gear / radius;
+}
+
+// Applies coulomb friction that can hold the robot still
+static double friction_applied(double force, double velocity, double friction) {
+  if (fabs(velocity) > 1e-4)
+    return force - ez::util::sgn(velocity) * friction;
+  if (fabs(force) <= friction)
+    return 0.0;
+  return force - ez::util::sgn(force) * friction;
+}
+
+void DriveSim::step(double dt) {
+  double track = constants.track_width * constants.scrub * METERS_PER_INCH;
+
+  while (dt > 1e-9) {
+    double h = fmin(dt, SUBSTEP);
+    dt -= h;
+
+    double v = current.velocity * METERS_PER_INCH;
+    double w = ez::util::to_rad(current.omega);
+    double theta = ez::util::to_rad(current.pose.theta);
+
+    // Wheel surface speeds, the drive scrubs so it turns like a wider robot
+    double v_left = v + w * track / 2.0;
+    double v_right = v - w * track / 2.0;
+
+    double left_ma = 0.0, right_ma = 0.0;
+    double f_left = motor_force(left_output, v_left, &left_ma);
+    double f_right = motor_force(right_output, v_right, &right_ma);
+
+    double force = friction_applied(f_left + f_right, v, constants.rolling_resistance);
+    double torque = friction_applied((f_left - f_right) * track / 2.0, w, constants.turn_resistance);
+
+    // Semi-implicit euler, update velocity and then position with the new velocity
+    v += force / constants.mass * h;
+    w += torque / constants.moment_of_inertia * h;
+    if (fabs(v) < 1e-4 && force == 0.0) v = 0.0;
+    if (fabs(w) < 1e-4 && torque == 0.0) w = 0.0;
+    theta += w * h;
+
+    v_left = v + w * track / 2.0;
+    v_right = v - w * track / 2.0;
+
+    current.time += h;
+    current.velocity = v / METERS_PER_INCH;
+    current.omega = ez::util::to_deg(w);
+    current.pose.x += v * sin(theta) * h / METERS_PER_INCH;
+    current.pose.y += v * cos(theta) * h / METERS_PER_INCH;
+    current.pose.theta = ez::util::to_deg(theta);
+    current.left_velocity = v_left / METERS_PER_INCH;
+    current.right_velocity = v_right / METERS_PER_INCH;
+    current.left_position += current.left_velocity * h;
+    current.right_position += current.right_velocity * h;
+    current.left_current = left_ma;
+    current.right_current = right_ma;
+
+    imu_bias += constants.imu_drift * h;
+  }
+
+  // The IMU is only sampled once per step, like a real sensor read
+  current.imu_heading = current.pose.theta + imu_bias + noise(rng) * constants.imu_noise;
+  current.imu_rate = current.omega + noise(rng) * constants.imu_noise * 10.0;
+}
+
+void DriveSim::run(double duration, double period, std::function<bool(DriveSim&)> controller) {
+  double end = current.time + duration;
+  while (current.time < end) {
+    if (!controller(*this))
+      break;
+    step(period);
+  }
+}
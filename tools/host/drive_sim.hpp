@@ -0,0 +1,132 @@
+#pragma once
+
+#include <functional>
+#include <random>
+
+#include "EZ-Template/util.hpp"
+
+/**
+ * Differential drive physics model.
+ *
+ * Models both sides of a tank drive as a bank of V5 motors driving the chassis
+ * through the wheels, with rotational scrub and a noisy IMU.  Positions are in
+ * inches and headings in degrees, using the same convention as EZ-Template's
+ * odometry (0 faces +y, positive is clockwise).
+ *
+ * Nothing in here touches a device, so this steps as fast as the CPU allows.
+ */
+class DriveSim {
+ public:
+  /**
+   * Physical constants of the simulated robot.
+   */
+  struct Constants {
+    int motors_per_side = 3;
+    double wheel_diameter = 3.25;      // inches
+    double wheel_rpm = 360.0;          // free speed at the wheel
+    double motor_rpm = 600.0;          // free speed of the cartridge
+    double motor_stall_torque = 0.35;  // N*m at the cartridge output
+    double motor_current_limit = 2.5;  // A, per motor
+    double track_width = 11.5;         // inches, center of left wheels to center of right wheels
+    double mass = 6.8;                 // kg
+    double moment_of_inertia = 0.16;   // kg*m^2 about the turning center
+    double scrub = 1.25;               // effective track width / track width while turning
+    double rolling_resistance = 0.8;   // N, opposes linear motion
+    double turn_resistance = 0.35;     // N*m, opposes turning
+    double battery_voltage = 12.8;     // V, the motors can't apply more than this
+    double imu_noise = 0.02;           // deg, standard deviation per sample
+    double imu_drift = 0.002;          // deg/s
+  };
+
+  /**
+   * Sampled state of the robot.
+   */
+  struct State {
+    double time = 0.0;         // s
+    ez::pose pose = {0, 0, 0};  // ground truth
+    double velocity = 0.0;     // in/s
+    double omega = 0.0;        // deg/s, clockwise positive
+    double left_position = 0.0;
+    double right_position = 0.0;
+    double left_velocity = 0.0;   // in/s
+    double right_velocity = 0.0;  // in/s
+    double left_current = 0.0;    // mA, one motor
+    double right_current = 0.0;   // mA, one motor
+    double imu_heading = 0.0;     // deg, noisy
+    double imu_rate = 0.0;        // deg/s, noisy
+  };
+
+  DriveSim();
+
+  /**
+   * Creates a simulator with custom constants.
+   *
+   * \param constants
+   *        physical constants of the robot
+   * \param seed
+   *        seed for the IMU noise, the same seed gives the same run
+   */
+  DriveSim(Constants constants, unsigned seed = 0);
+
+  /**
+   * Sets the output of each side of the drive, -127 to 127.
+   *
+   * \param left
+   *        left side output
+   * \param right
+   *        right side output
+   */
+  void drive_set(double left, double right);
+
+  /**
+   * Steps the model forward.  This is internally broken up into 1ms substeps.
+   *
+   * \param dt
+   *        time to step in seconds
+   */
+  void step(double dt);
+
+  /**
+   * Runs the model, calling a controller at a fixed period.
+   *
+   * The controller is called before each period and should read state() and
+   * call drive_set().  Returning false from the controller ends the run early.
+   *
+   * \param duration
+   *        max simulated time in seconds
+   * \param period
+   *        controller period in seconds
+   * \param controller
+   *        function run every period
+   */
+  void run(double duration, double period, std::function<bool(DriveSim&)> controller);
+
+  /**
+   * Returns the current state of the robot.
+   */
+  State state();
+
+  /**
+   * Resets the robot to a pose with zero velocity.
+   *
+   * \param pose
+   *        new pose of the robot
+   */
+  void reset(ez::pose pose = {0, 0, 0});
+
+  /**
+   * Returns the free speed of the drive in in/s.
+   */
+  double speed_max();
+
+  Constants constants;
+
+ private:
+  double motor_force(double command, double wheel_velocity, double* current);
+  State current;
+  double left_output = 0.0;
+  double right_output = 0.0;
+  double imu_bias = 0.0;
+  std::mt19937 rng;
+  std::normal_distribution<double> noise{0.0, 1.0};
+};
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+
+/**
+ * Host versions of the PROS scheduler and devices.
+ *
+ * PROS tasks run as threads, but only one of them runs at a time.  Time stands
+ * still while a task runs and jumps to the next wake up once every task is
+ * waiting, so programs run as fast as the CPU allows and two runs of the same
+ * program always match.  Devices read and write the port table below, and
+ * whatever simulates the robot fills it in from tick_set().
+ */
+namespace host {
+/**
+ * Returns simulated time since the program started in microseconds.
+ */
+uint64_t time_get();
+
+/**
+ * Sets a function that's run for every millisecond of simulated time.
+ *
+ * This runs inside the scheduler while tasks are paused, so it can read and
+ * write ports but can't call anything in pros::.
+ *
+ * \param tick
+ *        function run every simulated ms
+ */
+void tick_set(std::function<void()> tick);
+
+/**
+ * Everything a smart port reads back.  Motors write output and the settings,
+ * the simulation writes the rest.
+ */
+struct port {
+  double output = 0.0;         // motor command the way the motor turns, -127 to 127
+  double position = 0.0;       // revolutions of the cartridge output the way the motor turns
+  double velocity = 0.0;       // rpm of the cartridge output the way the motor turns
+  double current = 0.0;        // mA
+  double zero = 0.0;           // position at the last tare
+  int current_limit = 2500;    // mA
+  int brake_mode = 0;          // pros::motor_brake_mode_e_t
+  int gearing = 1;             // pros::motor_gearset_e_t, green by default like PROS
+  int units = 0;               // pros::motor_encoder_units_e_t
+  double heading = 0.0;        // IMU, deg, clockwise positive and doesn't wrap
+  double rate = 0.0;           // IMU, deg/s, clockwise positive
+  double heading_zero = 0.0;   // IMU heading at the last tare
+  double distance = 9999.0;    // distance sensor, mm, 9999 when nothing is in range
+};
+
+/**
+ * Returns the state of a smart port.
+ *
+ * \param port
+ *        smart port, 1 to 21.  Negative ports are the same port.
+ */
+port& port_get(int port);
+
+/**
+ * Returns the value last written to a three wire port.
+ *
+ * \param port
+ *        'A' to 'H', or 1 to 8
+ */
+int adi_get(int port);
+}  // namespace host
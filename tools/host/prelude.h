@@ -0,0 +1,11 @@
+// Forced into every host compile.  g++ predefines _GNU_SOURCE as 1 and
+// pros/screen.h redefines it empty, so match the PROS definition up front.
+#undef _GNU_SOURCE
+#define _GNU_SOURCE
+
+// pros::micros() is simulated time on the host, benchmarks time with the wall clock, see host/stubs.cpp
+#include <cstdint>
+namespace host {
+uint64_t wall_time_get();
+}
+#define BENCH_CLOCK host::wall_time_get
@@ -0,0 +1,394 @@
+// Host version of the PROS scheduler, see host.hpp.
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "host.hpp"
+#include "pros/rtos.hpp"
+
+namespace {
+const uint64_t NEVER = UINT64_MAX;
+
+struct task_record {
+  std::string name;
+  uint32_t priority;
+  uint64_t order;           // creation order, breaks ties between equal tasks
+  uint64_t wake = 0;        // us, when this task can run again
+  bool waiting = false;     // blocked in notify_take
+  bool deleted = false;
+  uint32_t notify_value = 0;
+  std::condition_variable turn;
+};
+
+struct mutex_record {
+  task_record* owner = nullptr;
+};
+
+struct scheduler {
+  std::mutex lock;
+  std::vector<task_record*> tasks;
+  task_record* running = nullptr;
+  uint64_t now = 0;  // us
+  std::function<void()> tick;
+};
+
+// Never destroyed, tasks are still waiting on it when the program exits
+scheduler& state() {
+  static scheduler* s = new scheduler;
+  return *s;
+}
+
+thread_local task_record* current = nullptr;
+
+task_record* record_add(const char* name, uint32_t priority) {
+  scheduler& s = state();
+  task_record* t = new task_record;
+  t->name = name != nullptr ? name : "";
+  t->priority = priority;
+  t->order = s.tasks.size();
+  t->wake = s.now;
+  s.tasks.push_back(t);
+  return t;
+}
+
+// The thread that first touches the scheduler becomes the main task, like the one that runs initialize()
+task_record* self() {
+  if (current == nullptr) {
+    current = record_add("main", TASK_PRIORITY_DEFAULT);
+    if (state().running == nullptr) state().running = current;
+  }
+  return current;
+}
+
+// Moves time forward, running the tick for every ms that passes
+void advance(uint64_t target) {
+  scheduler& s = state();
+  while (s.now < target) {
+    uint64_t next_ms = (s.now / 1000 + 1) * 1000;
+    if (next_ms > target) {
+      s.now = target;
+      break;
+    }
+    s.now = next_ms;
+    if (s.tick) s.tick();
+  }
+}
+
+// Hands the CPU to the highest priority task that's ready, moving time forward until one is
+void pick_next() {
+  scheduler& s = state();
+  while (true) {
+    task_record* next = nullptr;
+    uint64_t soonest = NEVER;
+    for (task_record* t : s.tasks) {
+      if (t->deleted) continue;
+      soonest = std::min(soonest, t->wake);
+      if (t->wake > s.now) continue;
+      if (next == nullptr || t->priority > next->priority ||
+          (t->priority == next->priority && (t->wake < next->wake || (t->wake == next->wake && t->order < next->order))))
+        next = t;
+    }
+    if (next != nullptr) {
+      s.running = next;
+      next->turn.notify_one();
+      return;
+    }
+    if (soonest == NEVER) {
+      printf("host: every task is blocked forever at %.3fs\n", s.now / 1000000.0);
+      fflush(stdout);
+      std::_Exit(1);
+    }
+    advance(soonest);
+  }
+}
+
+// Pauses the current task until it's picked again
+void reschedule(std::unique_lock<std::mutex>& l, task_record* me) {
+  pick_next();
+  me->turn.wait(l, [me] { return state().running == me; });
+}
+
+struct task_start {
+  task_record* record;
+  pros::task_fn_t function;
+  void* parameters;
+};
+}  // namespace
+
+namespace host {
+uint64_t time_get() { return state().now; }
+
+void tick_set(std::function<void()> tick) {
+  std::lock_guard<std::mutex> l(state().lock);
+  state().tick = std::move(tick);
+}
+}  // namespace host
+
+namespace pros {
+namespace c {
+// Only the running task reads the clock, and it can't move while that task runs
+uint32_t millis(void) { return state().now / 1000; }
+
+uint64_t micros(void) { return state().now; }
+
+task_t task_create(task_fn_t function, void* const parameters, uint32_t prio, const uint16_t stack_depth, const char* const name) {
+  std::unique_lock<std::mutex> l(state().lock);
+  task_record* me = self();
+  task_record* t = record_add(name, prio);
+  std::thread([start = task_start{t, function, parameters}]() {
+    {
+      std::unique_lock<std::mutex> l(state().lock);
+      current = start.record;
+      start.record->turn.wait(l, [&] { return state().running == start.record; });
+    }
+    start.function(start.parameters);
+
+    // The task returned, let everything else keep going
+    std::unique_lock<std::mutex> l(state().lock);
+    start.record->deleted = true;
+    pick_next();
+  }).detach();
+
+  // A higher priority task starts right away
+  me->wake = state().now;
+  reschedule(l, me);
+  return t;
+}
+
+void task_delete(task_t task) {
+  std::unique_lock<std::mutex> l(state().lock);
+  task_record* me = self();
+  task_record* t = task != nullptr ? (task_record*)task : me;
+  t->deleted = true;
+  if (t == me) {
+    pick_next();
+    me->turn.wait(l, [] { return false; });
+  }
+}
+
+void delay(const uint32_t milliseconds) {
+  std::unique_lock<std::mutex> l(state().lock);
+  task_record* me = self();
+  me->wake = state().now + milliseconds * 1000ull;
+  reschedule(l, me);
+}
+
+void task_delay(const uint32_t milliseconds) { delay(milliseconds); }
+
+void task_delay_until(uint32_t* const prev_time, const uint32_t delta) {
+  std::unique_lock<std::mutex> l(state().lock);
+  task_record* me = self();
+  *prev_time += delta;
+  me->wake = std::max<uint64_t>(state().now, *prev_time * 1000ull);
+  reschedule(l, me);
+}
+
+uint32_t task_get_priority(task_t task) {
+  std::lock_guard<std::mutex> l(state().lock);
+  return task != nullptr ? ((task_record*)task)->priority : self()->priority;
+}
+
+void task_set_priority(task_t task, uint32_t prio) {
+  std::unique_lock<std::mutex> l(state().lock);
+  task_record* me = self();
+  (task != nullptr ? (task_record*)task : me)->priority = prio;
+  me->wake = state().now;
+  reschedule(l, me);
+}
+
+task_state_e_t task_get_state(task_t task) {
+  std::lock_guard<std::mutex> l(state().lock);
+  task_record* t = task != nullptr ? (task_record*)task : self();
+  if (t->deleted) return E_TASK_STATE_DELETED;
+  if (t == state().running) return E_TASK_STATE_RUNNING;
+  return t->wake <= state().now ? E_TASK_STATE_READY : E_TASK_STATE_BLOCKED;
+}
+
+// Suspending isn't modeled, nothing in this project suspends tasks
+void task_suspend(task_t task) {}
+
+void task_resume(task_t task) {}
+
+uint32_t task_get_count(void) {
+  std::lock_guard<std::mutex> l(state().lock);
+  return std::count_if(state().tasks.begin(), state().tasks.end(), [](task_record* t) { return !t->deleted; });
+}
+
+char* task_get_name(task_t task) {
+  std::lock_guard<std::mutex> l(state().lock);
+  return (task != nullptr ? (task_record*)task : self())->name.data();
+}
+
+task_t task_get_by_name(const char* name) {
+  std::lock_guard<std::mutex> l(state().lock);
+  for (task_record* t : state().tasks)
+    if (!t->deleted && t->name == name) return t;
+  return nullptr;
+}
+
+task_t task_get_current() {
+  std::lock_guard<std::mutex> l(state().lock);
+  return self();
+}
+
+uint32_t task_notify(task_t task) { return task_notify_ext(task, 0, E_NOTIFY_ACTION_INCR, nullptr); }
+
+void task_join(task_t task) {
+  std::unique_lock<std::mutex> l(state().lock);
+  task_record* me = self();
+  while (!((task_record*)task)->deleted) {
+    me->wake = state().now + 1000;
+    reschedule(l, me);
+  }
+}
+
+uint32_t task_notify_ext(task_t task, uint32_t value, notify_action_e_t action, uint32_t* prev_value) {
+  std::unique_lock<std::mutex> l(state().lock);
+  task_record* me = self();
+  task_record* t = (task_record*)task;
+  if (prev_value != nullptr) *prev_value = t->notify_value;
+  bool pending = t->notify_value != 0;
+  switch (action) {
+    case E_NOTIFY_ACTION_BITS:
+      t->notify_value |= value;
+      break;
+    case E_NOTIFY_ACTION_INCR:
+      t->notify_value++;
+      break;
+    case E_NOTIFY_ACTION_OWRITE:
+      t->notify_value = value;
+      break;
+    case E_NOTIFY_ACTION_NO_OWRITE:
+      if (!pending) t->notify_value = value;
+      break;
+    default:
+      break;
+  }
+  if (t->waiting) t->wake = state().now;
+
+  // A higher priority waiter runs right away
+  me->wake = state().now;
+  reschedule(l, me);
+  return 1;
+}
+
+uint32_t task_notify_take(bool clear_on_exit, uint32_t timeout) {
+  std::unique_lock<std::mutex> l(state().lock);
+  task_record* me = self();
+  if (me->notify_value == 0) {
+    me->waiting = true;
+    me->wake = timeout == TIMEOUT_MAX ? NEVER : state().now + timeout * 1000ull;
+    reschedule(l, me);
+    me->waiting = false;
+  }
+  uint32_t value = me->notify_value;
+  if (value != 0) me->notify_value = clear_on_exit ? 0 : value - 1;
+  return value;
+}
+
+bool task_notify_clear(task_t task) {
+  std::lock_guard<std::mutex> l(state().lock);
+  task_record* t = task != nullptr ? (task_record*)task : self();
+  bool pending = t->notify_value != 0;
+  t->notify_value = 0;
+  return pending;
+}
+
+mutex_t mutex_create(void) { return new mutex_record; }
+
+bool mutex_take(mutex_t mutex, uint32_t timeout) {
+  std::unique_lock<std::mutex> l(state().lock);
+  task_record* me = self();
+  mutex_record* m = (mutex_record*)mutex;
+  uint64_t give_up = timeout == TIMEOUT_MAX ? NEVER : state().now + timeout * 1000ull;
+  while (m->owner != nullptr && m->owner != me) {
+    if (state().now >= give_up) return false;
+    me->wake = state().now + 1000;
+    reschedule(l, me);
+  }
+  m->owner = me;
+  return true;
+}
+
+bool mutex_give(mutex_t mutex) {
+  std::lock_guard<std::mutex> l(state().lock);
+  mutex_record* m = (mutex_record*)mutex;
+  if (m->owner != self()) return false;
+  m->owner = nullptr;
+  return true;
+}
+
+void mutex_delete(mutex_t mutex) { delete (mutex_record*)mutex; }
+}  // namespace c
+
+inline namespace rtos {
+Task::Task(task_fn_t function, void* parameters, std::uint32_t prio, std::uint16_t stack_depth, const char* name)
+    : task(c::task_create(function, parameters, prio, stack_depth, name)) {}
+
+Task::Task(task_fn_t function, void* parameters, const char* name)
+    : Task(function, parameters, TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, name) {}
+
+Task::Task(task_t task) : task(task) {}
+
+Task Task::current() { return Task(c::task_get_current()); }
+
+Task& Task::operator=(task_t in) {
+  task = in;
+  return *this;
+}
+
+void Task::remove() { c::task_delete(task); }
+
+std::uint32_t Task::get_priority() { return c::task_get_priority(task); }
+
+void Task::set_priority(std::uint32_t prio) { c::task_set_priority(task, prio); }
+
+std::uint32_t Task::get_state() { return c::task_get_state(task); }
+
+void Task::suspend() { c::task_suspend(task); }
+
+void Task::resume() { c::task_resume(task); }
+
+const char* Task::get_name() { return c::task_get_name(task); }
+
+std::uint32_t Task::notify() { return c::task_notify(task); }
+
+void Task::join() { c::task_join(task); }
+
+std::uint32_t Task::notify_ext(std::uint32_t value, notify_action_e_t action, std::uint32_t* prev_value) {
+  return c::task_notify_ext(task, value, action, prev_value);
+}
+
+std::uint32_t Task::notify_take(bool clear_on_exit, std::uint32_t timeout) { return c::task_notify_take(clear_on_exit, timeout); }
+
+bool Task::notify_clear() { return c::task_notify_clear(task); }
+
+void Task::delay(const std::uint32_t milliseconds) { c::delay(milliseconds); }
+
+void Task::delay_until(std::uint32_t* const prev_time, const std::uint32_t delta) { c::task_delay_until(prev_time, delta); }
+
+std::uint32_t Task::get_count() { return c::task_get_count(); }
+
+Clock::time_point Clock::now() { return time_point{duration{c::millis()}}; }
+
+Mutex::Mutex() : mutex(c::mutex_create(), c::mutex_delete) {}
+
+bool Mutex::take() { return c::mutex_take(mutex.get(), TIMEOUT_MAX); }
+
+bool Mutex::take(std::uint32_t timeout) { return c::mutex_take(mutex.get(), timeout); }
+
+bool Mutex::give() { return c::mutex_give(mutex.get()); }
+
+void Mutex::lock() { take(); }
+
+void Mutex::unlock() { give(); }
+
+bool Mutex::try_lock() { return take(0); }
+}  // namespace rtos
+}  // namespace pros
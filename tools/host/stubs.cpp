@@ -0,0 +1,90 @@
+// Host versions of the EZ-Template and PROS functions the project's
+// device-free code calls.  Every host build links this instead of the brain
+// libraries, see tools/Makefile.
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <sstream>
+#include <string>
+
+#include "EZ-Template/util.hpp"
+
+namespace ez {
+// No brain screen, text goes to the terminal
+void screen_print(std::string text, int line) { printf("%s\n", text.c_str()); }
+
+std::string exit_to_string(exit_output input) {
+  switch (input) {
+    case RUNNING:
+      return "Running";
+    case SMALL_EXIT:
+      return "Small";
+    case BIG_EXIT:
+      return "Big";
+    case VELOCITY_EXIT:
+      return "Velocity";
+    case mA_EXIT:
+      return "mA";
+    case ERROR_NO_CONSTANTS:
+      return "Error: Exit condition constants not set!";
+    default:
+      return "Error: Out of bounds!";
+  }
+}
+
+namespace util {
+bool AUTON_RAN = true;
+
+int sgn(double input) { return input > 0 ? 1 : input < 0 ? -1 : 0; }
+
+double clamp(double input, double max, double min) { return input > max ? max : input < min ? min : input; }
+
+double clamp(double input, double max) { return clamp(input, fabs(max), -fabs(max)); }
+
+double to_deg(double input) { return input * 180.0 / M_PI; }
+
+double to_rad(double input) { return input * M_PI / 180.0; }
+
+double wrap_angle(double theta) {
+  while (theta > 180.0) theta -= 360.0;
+  while (theta < -180.0) theta += 360.0;
+  return theta;
+}
+
+double absolute_angle_to_point(pose itarget, pose icurrent) {
+  double x_error = itarget.x - icurrent.x;
+  double y_error = itarget.y - icurrent.y;
+  if (x_error == 0.0 && y_error == 0.0) return icurrent.theta;
+  return to_deg(atan2(x_error, y_error));
+}
+
+double distance_to_point(pose itarget, pose icurrent) { return hypot(itarget.x - icurrent.x, itarget.y - icurrent.y); }
+
+// Both return the target as an absolute angle near current, going the short or long way
+double turn_shortest(double target, double current, bool print) { return current + wrap_angle(target - current); }
+
+double turn_longest(double target, double current, bool print) {
+  double error = wrap_angle(target - current);
+  return current + (error > 0.0 ? error - 360.0 : error + 360.0);
+}
+
+std::string to_string_with_precision(double input, int n) {
+  std::ostringstream out;
+  out.precision(n);
+  out << std::fixed << input;
+  return out.str();
+}
+}  // namespace util
+}  // namespace ez
+
+// There's no SD card on the host, anything that checks for one skips it
+namespace pros::usd {
+std::int32_t is_installed() { return 0; }
+}  // namespace pros::usd
+
+// Microseconds of real time since some fixed point, for BENCH_CLOCK
+uint64_t host::wall_time_get() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
@@ -0,0 +1,122 @@
+// Compares the odometry integrators against DriveSim's ground truth on the host.
+//
+// From the project root:
+//   make -C tools odom_bench
+//   ./tools/bin/odom_bench
+//
+// Each route is a minute of driving, stepped at 1ms.  Odometry samples the
+// wheels every loop and the IMU every 10ms like the real one, then every
+// integrator runs on the same samples.  Errors are inches from where the
+// simulator says the robot really is.
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "drive_sim.hpp"
+#include "odometry.hpp"
+
+static const double IMU_PERIOD = 0.010;
+
+// Left and right output for some time
+struct segment {
+  double left, right, time;
+};
+
+struct result {
+  double final_error;
+  double max_error;
+  double ns_per_loop;
+};
+
+static result run(const std::vector<segment>& route, DriveSim::Constants constants, double period, odometry::e_integrator method, bool interpolate) {
+  DriveSim sim(constants, 1);
+  ez::pose pose = {0, 0, 0};
+  odometry::HeadingInterpolator interpolator;
+  double imu_heading = 0.0, imu_rate = 0.0, imu_next = 0.0, next = 0.0;
+  double vertical_last = 0.0, heading_last = 0.0;
+  result out = {0, 0, 0};
+  double integrate_ns = 0.0;
+  int loops = 0;
+
+  for (const segment& s : route) {
+    sim.drive_set(s.left, s.right);
+    double end = sim.state().time + s.time;
+    while (sim.state().time < end - 1e-9) {
+      sim.step(0.001);
+      DriveSim::State state = sim.state();
+      if (state.time >= imu_next - 1e-9) {
+        imu_heading = state.imu_heading;
+        imu_rate = state.imu_rate;
+        imu_next += IMU_PERIOD;
+      }
+      if (state.time < next - 1e-9) continue;
+      next += period;
+
+      auto start = std::chrono::steady_clock::now();
+      double vertical = (state.left_position + state.right_position) / 2.0;
+      double heading = interpolate ? interpolator.get(imu_heading, imu_rate, state.time * 1000000.0) : imu_heading;
+      pose = odometry::integrate(method, pose, vertical - vertical_last, 0.0, heading - heading_last);
+      vertical_last = vertical;
+      heading_last = heading;
+      integrate_ns += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+      loops++;
+
+      out.max_error = fmax(out.max_error, hypot(pose.x - state.pose.x, pose.y - state.pose.y));
+    }
+  }
+  DriveSim::State state = sim.state();
+  out.final_error = hypot(pose.x - state.pose.x, pose.y - state.pose.y);
+  out.ns_per_loop = integrate_ns / loops;
+  return out;
+}
+
+static void compare(const char* name, const std::vector<segment>& route, DriveSim::Constants constants) {
+  const char* names[] = {"euler", "arc (float)", "exponential"};
+  printf("\n%s\n", name);
+  printf("  %-12s %6s %7s %9s %9s %8s\n", "integrator", "period", "interp", "final in", "max in", "ns/loop");
+  for (double period : {0.010, 0.005}) {
+    for (int method = odometry::EULER; method <= odometry::EXPONENTIAL; method++) {
+      for (bool interpolate : {false, true}) {
+        result r = run(route, constants, period, (odometry::e_integrator)method, interpolate);
+        printf("  %-12s %4.0fms %7s %9.3f %9.3f %8.1f\n", names[method], period * 1000.0, interpolate ? "yes" : "no",
+               r.final_error, r.max_error, r.ns_per_loop);
+      }
+    }
+  }
+}
+
+int main() {
+  // Long straights, sweeping arcs and point turns, like a skills run
+  std::vector<segment> skills;
+  for (int lap = 0; lap < 6; lap++) {
+    skills.push_back({110, 110, 1.2});
+    skills.push_back({110, 40, 1.5});
+    skills.push_back({0, 0, 0.4});
+    skills.push_back({-80, 80, 0.6});
+    skills.push_back({0, 0, 0.3});
+    skills.push_back({-100, -100, 0.9});
+    skills.push_back({30, 127, 1.8});
+    skills.push_back({0, 0, 0.3});
+    skills.push_back({90, -90, 0.5});
+    skills.push_back({127, 127, 1.5});
+    skills.push_back({0, 0, 0.5});
+  }
+  // A perfect IMU shows what the integrators themselves add, the real one's drift adds to all of them
+  DriveSim::Constants perfect;
+  perfect.imu_noise = 0.0;
+  perfect.imu_drift = 0.0;
+  compare("Skills route, perfect IMU", skills, perfect);
+  compare("Skills route, noisy IMU", skills, DriveSim::Constants{});
+
+  // Fast constant curvature is where loop rate and heading samples matter most
+  std::vector<segment> arcs;
+  for (int i = 0; i < 20; i++) {
+    arcs.push_back({127, 60, 1.5});
+    arcs.push_back({60, 127, 1.5});
+  }
+  compare("Fast S curves, perfect IMU", arcs, perfect);
+  compare("Fast S curves, noisy IMU", arcs, DriveSim::Constants{});
+  return 0;
+}
@@ -0,0 +1,103 @@
+// Compares Path::build_spline() against Path::build() + Path::smooth() on the host.
+//
+// From the project root:
+//   make -C tools path_bench
+//   ./tools/bin/path_bench
+//
+// Paths are built at the chassis path spacing the robot uses, 0.5in, and at
+// 2in.  The spline's curvature doesn't depend on the spacing but smoothing's
+// does: it rounds corners off more the further apart the points are, so at 2in
+// smoothing can have a lower peak curvature than the spline, at the cost of
+// missing the waypoints by more.
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+
+#include "path.hpp"
+#include "path_math.hpp"
+
+static const double SPACINGS[] = {0.5, 2.0};  // in, the first is the chassis default
+static const int ITERATIONS = 2000;
+
+struct quality {
+  double curvature_max;     // 1/in
+  double curvature_change;  // 1/in, biggest change between neighboring points
+  double waypoint_miss;     // in, furthest any waypoint is from the path
+  double length;            // in
+};
+
+// Measured the same way for both paths, from the points alone
+static quality measure(const Path& path, std::span<const ez::odom> input) {
+  quality q = {0, 0, 0, 0};
+  double last = 0.0;
+  for (int i = 1; i < path.amount() - 1; i++) {
+    double k = path_math::curvature_get(path[i - 1], path[i], path[i + 1]);
+    q.curvature_max = fmax(q.curvature_max, fabs(k));
+    if (i > 1) q.curvature_change = fmax(q.curvature_change, fabs(k - last));
+    last = k;
+  }
+  for (int i = 1; i < path.amount(); i++)
+    q.length += hypot(path[i].x - path[i - 1].x, path[i].y - path[i - 1].y);
+  for (const ez::odom& target : input) {
+    double closest = INFINITY;
+    for (int i = 0; i < path.amount(); i++)
+      closest = fmin(closest, hypot(path[i].x - target.target.x, path[i].y - target.target.y));
+    q.waypoint_miss = fmax(q.waypoint_miss, closest);
+  }
+  return q;
+}
+
+static double time_us(std::function<void()> f) {
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < ITERATIONS; i++) f();
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::micro>(end - start).count() / ITERATIONS;
+}
+
+static void compare(const char* name, ez::pose start, std::initializer_list<ez::odom> list) {
+  std::span<const ez::odom> input(list.begin(), list.size());
+  static PathBuffer<2048> smoothed, spline;
+
+  printf("\n%s\n", name);
+  printf("  %-14s %7s %8s %7s %9s %9s %9s %8s\n", "", "spacing", "us", "points", "max k", "max dk", "wp miss", "length");
+  for (double spacing : SPACINGS) {
+    double smooth_us = time_us([&] {
+      smoothed.build(start, input, spacing);
+      smoothed.smooth();
+    });
+    double spline_us = time_us([&] { spline.build_spline(start, input, spacing); });
+
+    quality a = measure(smoothed, input);
+    quality b = measure(spline, input);
+    printf("  %-14s %7.1f %8.1f %7i %9.4f %9.4f %9.3f %8.2f\n", "build+smooth", spacing, smooth_us, smoothed.amount(),
+           a.curvature_max, a.curvature_change, a.waypoint_miss, a.length);
+    printf("  %-14s %7.1f %8.1f %7i %9.4f %9.4f %9.3f %8.2f\n", "build_spline", spacing, spline_us, spline.amount(),
+           b.curvature_max, b.curvature_change, b.waypoint_miss, b.length);
+  }
+}
+
+int main() {
+  compare("S curve", {0, 0, 0},
+          {{{0, 24}, ez::fwd, 110},
+           {{24, 48}, ez::fwd, 110},
+           {{48, 48}, ez::fwd, 110},
+           {{72, 24}, ez::fwd, 110},
+           {{72, -24}, ez::fwd, 110}});
+  compare("Right angle", {0, 0, 0},
+          {{{0, 36}, ez::fwd, 110},
+           {{36, 36}, ez::fwd, 110}});
+  compare("Slalom", {0, 0, 0},
+          {{{12, 24}, ez::fwd, 110},
+           {{-12, 48}, ez::fwd, 110},
+           {{12, 72}, ez::fwd, 110},
+           {{-12, 96}, ez::fwd, 110},
+           {{0, 120}, ez::fwd, 110}});
+  compare("Out and back", {0, 0, 0},
+          {{{0, 24}, ez::fwd, 110},
+           {{24, 48}, ez::fwd, 110},
+           {{0, 24}, ez::rev, 110},
+           {{0, 0}, ez::rev, 110}});
+  return 0;
+}
@@ -0,0 +1,110 @@
+// Generates trajectory files for Trajectory::load() on the host.
+//
+// From the project root:
+//   make -C tools trajectory_gen
+//   ./tools/bin/trajectory_gen skills.traj 0,0 0,24 24,48 48,48 24,48,rev
+//
+// Waypoints are x,y in inches, with ,rev to drive backward to that point.  The
+// robot stops where it changes direction but can't turn there, so the first
+// point after a change should be about straight behind or ahead of it.  The
+// path is a spline through them, see Path::build_spline().  Copy the file to
+// the SD card and load it with Trajectory::load("/usd/skills.traj").
+//
+// Options, before the file name:
+//   -v  max velocity in in/s (55)
+//   -a  max acceleration in in/s^2 (100)
+//   -c  max lateral acceleration in corners in in/s^2 (60)
+//   -w  drive width in inches, the outside wheel is kept under max velocity (11.5)
+//   -s  spacing between points in inches (1)
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "path.hpp"
+#include "trajectory.hpp"
+
+static const int MAX_POINTS = 16384;
+
+int main(int argc, char** argv) {
+  double velocity = 55.0, acceleration = 100.0, lateral = 60.0, width = 11.5, spacing = 1.0;
+  int arg = 1;
+  for (; arg + 1 < argc && argv[arg][0] == '-'; arg += 2) {
+    double value = atof(argv[arg + 1]);
+    switch (argv[arg][1]) {
+      case 'v': velocity = value; break;
+      case 'a': acceleration = value; break;
+      case 'c': lateral = value; break;
+      case 'w': width = value; break;
+      case 's': spacing = value; break;
+      default: fprintf(stderr, "Unknown option %s\n", argv[arg]); return 1;
+    }
+  }
+  if (argc - arg < 3) {
+    fprintf(stderr, "Usage: %s [options] file.traj x,y x,y[,rev] ...\n", argv[0]);
+    return 1;
+  }
+  const char* out = argv[arg++];
+
+  std::vector<ez::odom> input;
+  for (; arg < argc; arg++) {
+    double x, y;
+    char direction[8] = "";
+    if (sscanf(argv[arg], "%lf,%lf,%7s", &x, &y, direction) < 2) {
+      fprintf(stderr, "Bad waypoint %s\n", argv[arg]);
+      return 1;
+    }
+    input.push_back({{x, y}, strcmp(direction, "rev") == 0 ? ez::rev : ez::fwd, 127});
+  }
+
+  static PathBuffer<MAX_POINTS> path;
+  if (!path.build_spline(input, spacing)) {
+    fprintf(stderr, "Too many waypoints or the path is too long\n");
+    return 1;
+  }
+  int n = path.amount();
+
+  // Fastest each point can be taken, then limit how fast that can be reached and left
+  std::vector<double> ds(n, 0.0), v(n);
+  for (int i = 0; i < n; i++) {
+    if (i > 0) ds[i] = hypot(path[i].x - path[i - 1].x, path[i].y - path[i - 1].y);
+    double k = fabs(path[i].curvature);
+    v[i] = velocity / (1.0 + k * width / 2.0);
+    if (k > 1e-9) v[i] = fmin(v[i], sqrt(lateral / k));
+
+    // Stop wherever the direction flips
+    if (i == 0 || i == n - 1 || path[i].direction != path[i + 1].direction) v[i] = 0.0;
+  }
+  for (int i = 1; i < n; i++) v[i] = fmin(v[i], sqrt(v[i - 1] * v[i - 1] + 2.0 * acceleration * ds[i]));
+  for (int i = n - 2; i >= 0; i--) v[i] = fmin(v[i], sqrt(v[i + 1] * v[i + 1] + 2.0 * acceleration * ds[i + 1]));
+
+  static Trajectory::point points[MAX_POINTS];
+  double time = 0.0;
+  for (int i = 0; i < n; i++) {
+    if (i > 0 && v[i - 1] + v[i] > 0.0) time += 2.0 * ds[i] / (v[i - 1] + v[i]);
+    int j = i + 1 < n ? i + 1 : i;
+    int k = i + 1 < n ? i : i - 1;
+    bool reverse = path[i].direction == ez::rev;
+    double theta = ez::util::to_deg(atan2(path[j].x - path[k].x, path[j].y - path[k].y));
+    double accel = i > 0 && ds[i] > 0.0 ? (v[i] * v[i] - v[i - 1] * v[i - 1]) / (2.0 * ds[i]) : 0.0;
+
+    // Backward the robot faces away from the path and turns the other way
+    points[i] = {time,
+                 path[i].x,
+                 path[i].y,
+                 ez::util::wrap_angle(reverse ? theta + 180.0 : theta),
+                 reverse ? -v[i] : v[i],
+                 reverse ? -accel : accel,
+                 reverse ? -path[i].curvature : path[i].curvature};
+  }
+
+  Trajectory trajectory(std::span<const Trajectory::point>(points, n));
+  if (!trajectory.save(out)) {
+    fprintf(stderr, "Couldn't write %s\n", out);
+    return 1;
+  }
+  printf("Wrote %s, %i points, %.2fs\n", out, n, trajectory.duration());
+  return 0;
+}